@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__async_mutex__hpp_INCLUDED_
+#define _disposer__async_mutex__hpp_INCLUDED_
+
+#include <mutex>
+#include <deque>
+#include <functional>
+
+
+namespace disposer{
+
+
+	/// \brief Lets one run at a time pass a module, in any run order
+	///
+	/// Instead of blocking, a run that finds the mutex locked registers a
+	/// continuation. unlock() passes the lock to the oldest registered
+	/// continuation and calls it.
+	class async_mutex{
+	public:
+		/// \brief The mutex is unlocked initially
+		async_mutex()noexcept: locked_(false) {}
+
+
+		/// \brief Mutexes are not copyable
+		async_mutex(async_mutex const&) = delete;
+
+		/// \brief Mutexes are not movable
+		async_mutex(async_mutex&&) = delete;
+
+
+		/// \brief Mutexes are not copyable
+		async_mutex& operator=(async_mutex const&) = delete;
+
+		/// \brief Mutexes are not movable
+		async_mutex& operator=(async_mutex&&) = delete;
+
+
+		/// \brief Lock the mutex or call continuation as soon as the lock
+		///        is passed to it
+		///
+		/// Returns true without calling continuation if the mutex was
+		/// unlocked. Otherwise continuation is called by the unlock() call
+		/// that passes the lock and false is returned.
+		bool async_lock(std::function< void() >&& continuation);
+
+		/// \brief Pass the lock to the next continuation or unlock
+		void unlock();
+
+
+	private:
+		/// \brief Protects locked_ and continuations_
+		std::mutex mutex_;
+
+		/// \brief true while a run holds the lock
+		bool locked_;
+
+		/// \brief The waiting runs, oldest first
+		std::deque< std::function< void() > > continuations_;
+	};
+
+
+}
+
+
+#endif
@@ -14,8 +14,20 @@
 #include "merge.hpp"
 #include "log_base.hpp"
 #include "log.hpp"
+#include "sequence_barrier.hpp"
+#include "exec_gate.hpp"
+#include "async_mutex.hpp"
+#include "stage_thread.hpp"
+#include "thread_pool.hpp"
+#include "data_pool.hpp"
+#include "memory_resources.hpp"
+#include "execution_plan.hpp"
+#include "exec_context.hpp"
 
 #include <mutex>
+#include <deque>
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 #include <condition_variable>
@@ -24,12 +36,34 @@
 namespace disposer{
 
 
+	/// \brief What a chain does with a new run while max_in_flight runs
+	///        are in progress
+	enum class overload_policy{
+		/// \brief Block the caller until a run is done
+		block,
+
+		/// \brief Reject the new run
+		fail,
+
+		/// \brief Drop the oldest run that did not start a module yet,
+		///        block if there is none
+		drop_oldest
+	};
+
+
 	/// \brief A process chain
 	///
 	/// Properties:
 	/// - no 2 identical modules (in different executions) must running
 	///   simultaneously
-	/// - it must not be overtaken
+	/// - it must not be overtaken, except in relaxed run order where only
+	///   ordered modules see the runs in order
+	/// - modules without data dependencies between them run concurrently
+	///   within one execution
+	/// - a module with replicas processes successive executions round-robin
+	///   on its replicas, so they can run simultaneously
+	/// - in demand driven mode, modules whose data nobody needs in an
+	///   execution are skipped
 	class chain{
 	public:
 		/// \brief Construct a proccess chain
@@ -37,13 +71,41 @@ namespace disposer{
 		/// \param config_chain configuration data from config file
 		/// \param generate_id Reference to a id_generator
 		/// \param group A reference to the group name
+		/// \param pool The thread_pool that executes the module steps
+		/// \param resources The memory resources of the config file
 		///
 		/// The id increase for the id_generator is calculated over all modules.
+		///
+		/// The chain uses the resource named in the config chain for its
+		/// internal lists and the states of its runs, or else the default
+		/// resource of resources.
+		///
+		/// The config lines 'max_in_flight = count' and
+		/// 'overload_policy = block|fail|drop_oldest' set the limit of
+		/// runs in progress. The inputs of the modules then hold the data
+		/// of count runs without lock, otherwise of 8 runs.
+		///
+		/// The config line 'run_order = relaxed' lets runs overtake each
+		/// other in all modules that are not ordered. Modules whose
+		/// variables nobody reads and modules with the chain module
+		/// parameter 'ordered = true' are ordered, they wait for the older
+		/// runs and so get the data in run order. Unordered modules take
+		/// the runs in the order they get ready, one run per replica at a
+		/// time.
+		///
+		/// A module with the chain module parameter 'stage = name' runs on
+		/// a dedicated thread that it shares only with the other modules
+		/// of this stage. 'cpus = 0,2-3' pins the thread of the stage to
+		/// these CPUs, a module with 'cpus' but without 'stage' gets a
+		/// stage of its own. All modules of a stage must have the same
+		/// 'cpus'. The runs flow between the stages over their queues.
 		chain(
 			module_maker_list const& maker_list,
 			types::merge::chain const& config_chain,
 			id_generator& generate_id,
-			std::string const& group
+			std::string const& group,
+			thread_pool& pool,
+			memory_resources const& resources
 		);
 
 
@@ -75,8 +137,47 @@ namespace disposer{
 		/// 3.2 Next module is executed
 		/// 3.3 if not last module then back to 3.1
 		///
-		/// If a module throws an exception,
-		void exec();
+		/// The modules are executed in the calling thread until the run has
+		/// to wait for a previous run. The rest of the run is then executed
+		/// in the thread_pool and the calling thread blocks until it is
+		/// done.
+		///
+		/// If a module throws an exception, cleanup() is called for this and
+		/// all following modules and the exception is rethrown.
+		///
+		/// A module that calls module_base::abort_run() stops the run the
+		/// same way, but without exception. After module_base::skip_rest()
+		/// only the modules that depend on the module get cleanup() calls.
+		///
+		/// Returns true if the run was completed. Returns false if a module
+		/// aborted the run or if the run was rejected or dropped because
+		/// of max_in_flight. A rejected run gets no id.
+		///
+		/// A worker of the thread_pool executes other tasks while it waits
+		/// for the run. If one of them calls exec() again, the calls nest
+		/// on the stack of the worker. The depth is limited by the count
+		/// of exec() calls that modules make concurrently, so modules
+		/// should not call exec() recursively.
+		///
+		/// The stage threads of the chain must not call exec(), they would
+		/// wait for a run that may need them. It throws std::logic_error
+		/// without using an id then. Use exec_async() instead.
+		bool exec();
+
+		/// \brief Execute the proccess chain in the thread_pool
+		///
+		/// The chain must be enabled, otherwise an exception is thrown.
+		///
+		/// Every module is a separate step in the thread_pool. As soon as a
+		/// run leaves a module, the next run can enter it, so the runs of a
+		/// chain are processed like in a pipeline.
+		///
+		/// The future gets the exception if a module throws. The exception
+		/// handling and the result are the same as in exec(). With the
+		/// policy overload_policy::block the call blocks until the run can
+		/// start. On a stage thread of the chain it throws
+		/// std::logic_error instead of blocking.
+		std::future< bool > exec_async();
 
 
 		/// \brief Enables the chain for exec calls
@@ -90,6 +191,109 @@ namespace disposer{
 		void disable()noexcept;
 
 
+		/// \brief Enable or disable the demand driven mode
+		///
+		/// At the start of every run, the chain asks the inputs with
+		/// input_base::demands() if they need the data of the run. A
+		/// module is skipped if no input of an executed module needs its
+		/// variables. Skipped modules get a cleanup() call like after an
+		/// exception and let the next run pass as usual. Modules whose
+		/// variables are not read by any module are always executed.
+		///
+		/// Takes effect with the next run.
+		void set_demand_driven(bool enable)noexcept{
+			demand_driven_.store(enable, std::memory_order_relaxed);
+		}
+
+		/// \brief true if the chain is in demand driven mode
+		bool is_demand_driven()const noexcept{
+			return demand_driven_.load(std::memory_order_relaxed);
+		}
+
+
+		/// \brief Limit the count of runs in progress
+		///
+		/// If max runs are in progress, a new exec() or exec_async() call
+		/// is handled by policy. 0 means no limit.
+		///
+		/// Takes effect with the next run. While the chain is disabled,
+		/// the inputs also resize their slot rings to hold the data of
+		/// max runs without lock. An enabled chain keeps the size of the
+		/// rings, the data of further runs goes to the locked overflow
+		/// lists then.
+		void set_max_in_flight(
+			std::size_t max,
+			overload_policy policy = overload_policy::block
+		);
+
+		/// \brief Maximum count of runs in progress, 0 means no limit
+		std::size_t max_in_flight()const noexcept{
+			return max_in_flight_.load(std::memory_order_relaxed);
+		}
+
+		/// \brief Count of runs that were rejected by overload_policy::fail
+		std::size_t rejected_runs()const noexcept{
+			return rejected_runs_.load(std::memory_order_relaxed);
+		}
+
+		/// \brief Count of runs that were dropped by
+		///        overload_policy::drop_oldest
+		std::size_t dropped_runs()const noexcept{
+			return dropped_runs_.load(std::memory_order_relaxed);
+		}
+
+
+		/// \brief Enable or disable the latest wins mode
+		///
+		/// A new run drops all runs that did not start a module yet, so
+		/// after a backlog only the newest run enters the modules. Dropped
+		/// runs pass all modules with cleanup() calls and exec() returns
+		/// false for them. If max_in_flight runs are in progress, a new run
+		/// takes the place of a pending one instead of applying the
+		/// overload_policy.
+		///
+		/// Takes effect with the next run.
+		void set_latest_wins(bool enable)noexcept{
+			latest_wins_.store(enable, std::memory_order_relaxed);
+		}
+
+		/// \brief true if the chain is in latest wins mode
+		bool is_latest_wins()const noexcept{
+			return latest_wins_.load(std::memory_order_relaxed);
+		}
+
+		/// \brief Count of runs that were dropped in latest wins mode
+		std::size_t coalesced_runs()const noexcept{
+			return coalesced_runs_.load(std::memory_order_relaxed);
+		}
+
+
+		/// \brief true if runs can overtake each other in unordered
+		///        modules
+		bool is_relaxed_order()const noexcept{ return relaxed_order_; }
+
+
+		/// \brief Count of pipeline stages with a dedicated thread
+		std::size_t stage_count()const noexcept{ return stages_.size(); }
+
+		/// \brief The stage i, its thread counts the executed module steps
+		///        and the time spent in them
+		stage_thread const& stage(std::size_t i)const{
+			return *stages_.at(i);
+		}
+
+
+		/// \brief The pools of the data of all module inputs and outputs
+		///
+		/// There is one pool per data type, it counts hits and misses.
+		data_pools const& pools()const noexcept{ return pools_; }
+
+		/// \brief The memory resource of the chain
+		std::pmr::memory_resource& memory_resource()const noexcept{
+			return memory_;
+		}
+
+
 		/// \brief Name of the chain
 		std::string const name;
 
@@ -98,56 +302,231 @@ namespace disposer{
 
 
 	private:
-		/// \brief Handles the exec and the cleanup of a module
+		/// \brief State of an exec_async() call
+		class run_state;
+
+
+		/// \brief Set the id and call action with log
+		///
+		/// action is called with the replica of module i that processes
+		/// the run.
 		template < typename F >
-		void process_module(
+		void run_module(
 			std::size_t const i,
-			std::size_t const run,
+			run_state const& state,
 			F const& action,
 			char const* const action_name
 		);
 
 
-		/// \brief List of modules
-		std::vector< module_ptr > const modules_;
+		/// \brief Create the state of a new run
+		///
+		/// Returns nullptr if the run is rejected.
+		std::shared_ptr< run_state > new_run();
 
+		/// \brief Let run pass all ordered modules without processing
+		///
+		/// Called for a run number whose run could not be created, so the
+		/// later runs do not wait for it forever.
+		void pass_run(std::size_t run);
+
+		/// \brief Let all inputs hold the data of count runs without lock
+		///
+		/// The chain must be disabled.
+		void set_slot_count(std::size_t count);
+
+		/// \brief Take one of the max_in_flight places for a new run
+		///
+		/// Returns false if the run is rejected.
+		bool admit();
+
+		/// \brief Take a place if one is free
+		bool try_take_place()noexcept;
+
+		/// \brief Free the place of a run
+		void free_place();
+
+		/// \brief Drop the oldest run that did not start, true on success
+		///
+		/// The new run takes the place of the dropped one. counter is
+		/// incremented on success.
+		bool drop_oldest_pending(std::atomic< std::size_t >& counter);
+
+
+		/// \brief Mark the modules whose data nobody needs in the run
+		void mark_demanded(exec_context& context)const;
+
+		/// \brief Mark all modules that read data of module i, directly or
+		///        indirectly, as not demanded
+		void skip_dependents(exec_context& context, std::size_t i)const;
+
+
+		/// \brief Enter all modules without dependencies
+		///
+		/// If exec_inline is true, the first module that is ready is
+		/// processed in the calling thread.
+		void start_run(
+			std::shared_ptr< run_state > const& state,
+			bool exec_inline
+		);
+
+		/// \brief Wait until the run can pass module i
+		///
+		/// Returns true if the run can pass immediately, otherwise
+		/// post_steps() is called as soon as the run can pass.
+		bool enter_module(
+			std::shared_ptr< run_state > const& state,
+			std::size_t i
+		);
+
+		/// \brief Let the next run pass module i
+		void leave_module(
+			std::shared_ptr< run_state > const& state,
+			std::size_t i
+		);
+
+		/// \brief The mutex of the replica of unordered module i that
+		///        processes run
+		async_mutex& exclusive(std::size_t i, std::size_t run)noexcept{
+			auto const& step = plan_[i];
+			return exclusive_[step.first_replica + run % step.replica_count];
+		}
+
+		/// \brief true if module i can be processed in the calling thread
+		///
+		/// Modules of a stage run only on its thread, all other modules
+		/// not on a stage thread.
+		bool runs_here(std::size_t i)const noexcept{
+			return module_stages_[i] == stage_thread::current();
+		}
+
+		/// \brief Throw if the calling thread is a stage thread of the
+		///        chain
+		///
+		/// what is the operation that the thread would block in.
+		void verify_no_stage_thread(char const* what)const;
+
+		/// \brief Process modules starting with module i in the thread_pool
+		///        or on the thread of its stage
+		void post_steps(
+			std::shared_ptr< run_state > const& state,
+			std::size_t i
+		);
+
+		/// \brief Process modules starting with module i
+		///
+		/// The run must already be allowed to pass module i. Afterwards
+		/// all successors whose dependencies are done are entered. The
+		/// first one that the run can pass without waiting is processed in
+		/// this thread, the others in the thread_pool.
+		void exec_steps(
+			std::shared_ptr< run_state > const& state,
+			std::size_t i
+		);
+
+
+		/// \brief One pool per data type
+		data_pools pools_;
+
+		/// \brief Memory of the internal lists and the run states
+		std::pmr::memory_resource& memory_;
 
-		/// \brief Increase for the id_generator
-		std::size_t const id_increase_;
+		/// \brief List of modules, each with all its replicas
+		std::vector< module_replicas > const modules_;
+
+		/// \brief true if the config line 'run_order = relaxed' is set
+		bool const relaxed_order_;
+
+		/// \brief Dependencies and entry points of all modules
+		execution_plan const plan_;
 
 		/// \brief Referenz to the id_generator
 		id_generator& generate_id_;
 
+		/// \brief Referenz to the thread_pool of the disposer
+		thread_pool& pool_;
+
 
 		/// \brief Count of exec() calls
 		std::atomic< std::size_t > next_run_;
 
-		/// \brief One entry per module, value is the last run id
+		/// \brief true if modules without demand are skipped
+		std::atomic< bool > demand_driven_;
+
+
+		/// \brief Maximum count of runs in progress, 0 means no limit
+		std::atomic< std::size_t > max_in_flight_;
+
+		/// \brief Handling of new runs if max_in_flight_ runs are in
+		///        progress
+		std::atomic< overload_policy > overload_policy_;
+
+		/// \brief Count of runs in progress
+		std::atomic< std::size_t > in_flight_;
+
+		/// \brief Count of threads that wait for a place
+		std::atomic< std::size_t > place_waiters_;
+
+		/// \brief Protects the wake up of waiting threads
+		std::mutex place_mutex_;
+
+		/// \brief Threads wait here for a place
+		std::condition_variable place_cv_;
+
+		/// \brief Protects pending_runs_
+		std::mutex pending_mutex_;
+
+		/// \brief Runs that might not have started a module yet, oldest
+		///        first
 		///
-		/// The run id is generated by next_run_ in exec()
-		std::vector< std::size_t > ready_run_;
+		/// Only used with overload_policy::drop_oldest and in latest wins
+		/// mode.
+		std::deque< std::weak_ptr< run_state > > pending_runs_;
 
+		/// \brief Count of runs rejected by overload_policy::fail
+		std::atomic< std::size_t > rejected_runs_;
 
-		/// \brief One mutex per module
-		std::vector< std::mutex > module_mutexes_;
+		/// \brief Count of runs dropped by overload_policy::drop_oldest
+		std::atomic< std::size_t > dropped_runs_;
 
-		/// \brief Manages the module_mutexes_
-		std::condition_variable module_cv_;
+		/// \brief true if a new run drops all runs that did not start
+		std::atomic< bool > latest_wins_;
+
+		/// \brief Count of runs dropped in latest wins mode
+		std::atomic< std::size_t > coalesced_runs_;
+
+		/// \brief One entry per module, lets the runs pass in order
+		///
+		/// The run id is generated by next_run_ in exec(). The barrier of
+		/// a module has one lane per replica.
+		std::deque< sequence_barrier > ready_run_;
+
+		/// \brief One entry per replica, lets one run at a time pass an
+		///        unordered module in any order
+		///
+		/// Only used in relaxed run order, the replicas of module i start
+		/// at plan_[i].first_replica.
+		std::deque< async_mutex > exclusive_;
 
 
 		/// \brief Mutex for enable and disable
 		std::mutex enable_mutex_;
 
-		/// \brief true after successfull enable() call
+		/// \brief Open after successfull enable() call, counts the active
+		///        runs
 		///
-		/// Call disable() to set it to false.
-		std::atomic< bool > enabled_;
+		/// Call disable() to close it.
+		exec_gate gate_;
 
-		/// \brief Count of active exec() calls
-		std::atomic< std::size_t > exec_calls_count_;
+		/// \brief The dedicated threads of the pipeline stages
+		///
+		/// Declared last, so the threads are joined before anything they
+		/// use is destroyed.
+		std::vector< std::unique_ptr< stage_thread > > stages_;
 
-		/// \brief Manages exec() and enable() / disable() calls
-		std::condition_variable enable_cv_;
+		/// \brief Per module its stage thread, nullptr if the module runs
+		///        in the thread_pool
+		std::vector< stage_thread* > module_stages_;
 	};
 
 
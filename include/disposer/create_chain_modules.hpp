@@ -11,14 +11,56 @@
 
 #include "module_ptr.hpp"
 #include "merge.hpp"
+#include "data_pool.hpp"
+#include "memory_resources.hpp"
 
 
 namespace disposer{
 
 
-	std::vector< module_ptr > create_chain_modules(
+	/// \brief Create and connect all modules of a chain
+	///
+	/// A module with the chain module parameter 'replicas = N' is created
+	/// N times. Replica r % N processes run r.
+	///
+	/// The data of all inputs and outputs is allocated from pools.
+	///
+	/// The pools and the lists of the inputs and outputs of a module use
+	/// the memory resource of the chain module parameter
+	/// 'memory_resource = name', or else the resource of the chain.
+	std::vector< module_replicas > create_chain_modules(
 		module_maker_list const& maker_list,
-		types::merge::chain const& config_chain
+		types::merge::chain const& config_chain,
+		data_pools& pools,
+		memory_resources const& resources
+	);
+
+	/// \brief An input that reads a variable of a module
+	struct consumer{
+		/// \brief Number of the reading module
+		std::size_t module;
+
+		/// \brief Position of the input in the input list of the module
+		std::size_t input;
+	};
+
+	/// \brief Per module the list of inputs that read its variables
+	///
+	/// A reading module always comes after the module in the chain.
+	std::pmr::vector< std::pmr::vector< consumer > > module_consumers(
+		types::merge::chain const& config_chain,
+		std::vector< module_replicas > const& modules,
+		std::pmr::memory_resource& resource
+	);
+
+	/// \brief Per module the list of modules that depend on it
+	///
+	/// A module depends on the modules that produce its input variables.
+	/// The last module that reads a variable gets it with last_use and may
+	/// move the data, so it also depends on all other readers.
+	std::pmr::vector< std::pmr::vector< std::size_t > > module_successors(
+		types::merge::chain const& config_chain,
+		std::pmr::memory_resource& resource
 	);
 
 
@@ -0,0 +1,289 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__data_pool__hpp_INCLUDED_
+#define _disposer__data_pool__hpp_INCLUDED_
+
+#include <boost/type_index.hpp>
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <memory_resource>
+
+
+namespace disposer{
+
+
+	class data_pool;
+
+	/// \brief std::shared_ptr of data_pool
+	using data_pool_ptr = std::shared_ptr< data_pool >;
+
+
+	/// \brief Recycling storage for the shared data of one type
+	///
+	/// The pool keeps freed blocks and reuses them for the next
+	/// allocations. All blocks of a pool have the size of the first
+	/// allocation, allocations of another size bypass the pool.
+	///
+	/// The first threads that use a pool get a small free list of their
+	/// own, which they use without lock or atomic read-modify-write
+	/// operation. A full or empty thread list exchanges half of its
+	/// blocks with the shared list, which is protected by a mutex. Threads
+	/// beyond thread_lists use the shared list only.
+	///
+	/// New blocks are allocated from the upstream resource.
+	class data_pool{
+	public:
+		/// \brief Default count of freed blocks in the shared list
+		static constexpr std::size_t default_capacity = 64;
+
+		/// \brief Count of threads that get a free list of their own
+		static constexpr std::size_t thread_lists = 16;
+
+		/// \brief Count of freed blocks per thread list
+		static constexpr std::size_t thread_capacity = 16;
+
+
+		/// \brief Create a pool
+		///
+		/// If blocks of the pool are still in use when the last owner
+		/// releases the pool, the pool is kept until the end of the
+		/// program, so the blocks can be given back safely.
+		static data_pool_ptr make(
+			std::pmr::memory_resource& upstream =
+				*std::pmr::get_default_resource(),
+			std::size_t capacity = default_capacity
+		);
+
+
+		/// \brief Pools are not copyable
+		data_pool(data_pool const&) = delete;
+
+		/// \brief Pools are not copyable
+		data_pool& operator=(data_pool const&) = delete;
+
+
+		/// \brief Get a block of size bytes with alignment align
+		///
+		/// Only blocks with at most the alignment of std::max_align_t are
+		/// reused.
+		void* allocate(
+			std::size_t size,
+			std::size_t align = alignof(std::max_align_t)
+		);
+
+		/// \brief Give back a block of allocate(size, align)
+		void deallocate(
+			void* block,
+			std::size_t size,
+			std::size_t align = alignof(std::max_align_t)
+		)noexcept;
+
+
+		/// \brief Count of allocations served by a kept block
+		std::size_t hits()const noexcept;
+
+		/// \brief Count of allocations that did allocate new memory
+		std::size_t misses()const noexcept{
+			return misses_.load(std::memory_order_acquire);
+		}
+
+		/// \brief The resource of new blocks
+		std::pmr::memory_resource& upstream()const noexcept{
+			return upstream_;
+		}
+
+
+	private:
+		/// \brief The free list of one thread
+		struct alignas(64) thread_list{
+			/// \brief Count of blocks in the list
+			std::size_t count = 0;
+
+			/// \brief The blocks
+			void* blocks[thread_capacity];
+
+			/// \brief Count of allocations served by the list
+			///
+			/// Only the owning thread writes it.
+			std::atomic< std::size_t > hits{0};
+
+			/// \brief Count of blocks the owning thread gave back
+			///
+			/// Only the owning thread writes it.
+			std::atomic< std::size_t > frees{0};
+		};
+
+
+		/// \brief Constructor
+		data_pool(std::pmr::memory_resource& upstream, std::size_t capacity);
+
+		/// \brief Free all kept blocks
+		~data_pool();
+
+
+		/// \brief Delete the pool if none of its blocks is in use
+		static void release(data_pool* pool)noexcept;
+
+		/// \brief The list of the calling thread or nullptr
+		thread_list* local_list()noexcept;
+
+		/// \brief Move blocks from the shared list to list
+		void refill(thread_list& list);
+
+		/// \brief Move blocks from list to the shared list or upstream
+		void spill(thread_list& list)noexcept;
+
+		/// \brief Count of blocks that were allocated and not given back
+		std::size_t in_use()const noexcept;
+
+
+		/// \brief The resource of new blocks
+		std::pmr::memory_resource& upstream_;
+
+		/// \brief Maximal count of kept blocks in the shared list
+		std::size_t const capacity_;
+
+		/// \brief Size of the blocks, 0 before the first allocation
+		std::atomic< std::size_t > block_size_;
+
+		/// \brief One free list per thread
+		std::unique_ptr< thread_list[] > thread_lists_;
+
+		/// \brief Protects free_
+		std::mutex mutex_;
+
+		/// \brief The shared list of kept blocks
+		std::pmr::vector< void* > free_;
+
+		/// \brief Count of allocations served by the shared list
+		std::atomic< std::size_t > hits_;
+
+		/// \brief Count of allocations that did allocate new memory
+		std::atomic< std::size_t > misses_;
+
+		/// \brief Count of blocks given back without thread list
+		std::atomic< std::size_t > frees_;
+	};
+
+
+	/// \brief Allocator for std::allocate_shared that uses a data_pool
+	///
+	/// The allocator refers to the pool without ownership, copies cost no
+	/// atomic reference counting. Pools from data_pool::make() stay alive
+	/// while their blocks are in use.
+	template < typename T >
+	class pool_allocator{
+	public:
+		using value_type = T;
+
+
+		/// \brief Constructor
+		explicit pool_allocator(data_pool& pool)noexcept:
+			pool_(&pool) {}
+
+		/// \brief Rebind constructor
+		template < typename U >
+		pool_allocator(pool_allocator< U > const& other)noexcept:
+			pool_(&other.pool()) {}
+
+
+		/// \brief Get memory for n objects
+		T* allocate(std::size_t n){
+			return static_cast< T* >(
+				pool_->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		/// \brief Give back memory of allocate(n)
+		void deallocate(T* p, std::size_t n)noexcept{
+			pool_->deallocate(p, n * sizeof(T), alignof(T));
+		}
+
+
+		/// \brief The pool
+		data_pool& pool()const noexcept{ return *pool_; }
+
+
+	private:
+		/// \brief The pool
+		data_pool* pool_;
+	};
+
+	template < typename T, typename U >
+	bool operator==(
+		pool_allocator< T > const& l,
+		pool_allocator< U > const& r
+	)noexcept{
+		return &l.pool() == &r.pool();
+	}
+
+	template < typename T, typename U >
+	bool operator!=(
+		pool_allocator< T > const& l,
+		pool_allocator< U > const& r
+	)noexcept{
+		return !(l == r);
+	}
+
+
+	/// \brief Create a T in memory of pool, or via std::make_shared if pool
+	///        is empty
+	template < typename T, typename ... Args >
+	std::shared_ptr< T > make_pooled(
+		data_pool_ptr const& pool,
+		Args&& ... args
+	){
+		if(!pool){
+			return std::make_shared< T >(static_cast< Args&& >(args) ...);
+		}
+
+		return std::allocate_shared< T >(
+			pool_allocator< T >(*pool), static_cast< Args&& >(args) ...);
+	}
+
+
+	/// \brief The data_pool's of a chain, one per data type and memory
+	///        resource
+	class data_pools{
+	public:
+		/// \brief Data type and upstream resource of a pool
+		using key = std::pair<
+			boost::typeindex::type_index, std::pmr::memory_resource* >;
+
+		/// \brief Map from data type and resource to its pool
+		using map = std::map< key, data_pool_ptr >;
+
+
+		/// \brief Get the pool of type, create it if it does not exist
+		///
+		/// Only called while the chain is created.
+		data_pool_ptr const& get(
+			boost::typeindex::type_index const& type,
+			std::pmr::memory_resource& resource
+		);
+
+		/// \brief All pools of the chain
+		map const& pools()const noexcept{ return pools_; }
+
+
+	private:
+		/// \brief The pools
+		map pools_;
+	};
+
+
+}
+
+
+#endif
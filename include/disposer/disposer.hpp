@@ -57,7 +57,10 @@ namespace disposer{
 	class disposer{
 	public:
 		/// \brief Constructor
-		disposer();
+		///
+		/// \param thread_count Count of worker threads that execute the
+		///                     chains, 0 means one per hardware thread
+		explicit disposer(std::size_t thread_count = 0);
 
 
 		/// \brief Not copyable
@@ -78,6 +81,24 @@ namespace disposer{
 		module_declarant& declarant();
 
 
+		/// \brief Register a memory resource for the config file
+		///
+		/// Chains use it with the line '\t\tmemory_resource = name' and
+		/// modules with the chain module parameter 'memory_resource = name'.
+		/// The resource must outlive the disposer. Call before load().
+		void add_memory_resource(
+			std::string const& name,
+			std::pmr::memory_resource& resource
+		);
+
+		/// \brief Set the resource of chains and modules without a
+		///        configured resource
+		///
+		/// The default is std::pmr::get_default_resource(). The resource
+		/// must outlive the disposer. Call before load().
+		void set_memory_resource(std::pmr::memory_resource& resource);
+
+
 		/// \brief Load and parse the config file
 		void load(std::string const& filename);
 
@@ -114,6 +135,14 @@ namespace disposer{
 		/// \brief List of modules (map from module type name to maker function)
 		module_maker_list maker_list_;
 
+		/// \brief Named memory resources for the config file
+		memory_resources memory_resources_;
+
+		/// \brief Executes the module steps of all chains
+		///
+		/// Must be destroyed after the chains.
+		thread_pool pool_;
+
 		/// \brief List of alle chains (map from name to object)
 		std::unordered_map< std::string, chain > chains_;
 
@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__exec_context__hpp_INCLUDED_
+#define _disposer__exec_context__hpp_INCLUDED_
+
+#include <any>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <memory_resource>
+
+
+namespace disposer{
+
+
+	/// \brief The state of one run of a chain
+	///
+	/// The chain creates one context per run. While a module processes the
+	/// run, the context is the current context of the executing thread, so
+	/// inputs and outputs find the id of the run without a copy of it in
+	/// every module, input and output.
+	///
+	/// The context owns a monotonic arena for the memory of the run. It is
+	/// released as a whole when the run is done.
+	class exec_context{
+	public:
+		/// \brief Clock of the timing information
+		using clock = std::chrono::steady_clock;
+
+
+		/// \brief Constructor
+		///
+		/// \param id The id of the run
+		/// \param run The continuous index of the run in its chain
+		/// \param module_count Count of modules in the chain
+		exec_context(std::size_t id, std::size_t run, std::size_t module_count):
+			id(id),
+			run(run),
+			start(clock::now()),
+			memory_(buffer_, sizeof(buffer_)),
+			scratch_(
+				module_count,
+				std::pmr::polymorphic_allocator< std::any >(&memory_)
+			),
+			demanded_(
+				module_count,
+				std::pmr::polymorphic_allocator< std::atomic< bool > >(
+					&memory_)
+			)
+		{
+			for(auto& flag: demanded_){
+				flag.store(true, std::memory_order_relaxed);
+			}
+		}
+
+
+		/// \brief Contexts are not copyable
+		exec_context(exec_context const&) = delete;
+
+		/// \brief Contexts are not movable
+		exec_context(exec_context&&) = delete;
+
+
+		/// \brief Contexts are not copyable
+		exec_context& operator=(exec_context const&) = delete;
+
+		/// \brief Contexts are not movable
+		exec_context& operator=(exec_context&&) = delete;
+
+
+		/// \brief The context of the run the calling thread processes or
+		///        nullptr
+		static exec_context* current()noexcept;
+
+		/// \brief The context of the run the calling thread processes
+		///
+		/// Throws if the calling thread does not process a run.
+		static exec_context& get();
+
+
+		/// \brief Free storage of module number for the duration of the run
+		std::any& scratch(std::size_t number)noexcept{
+			return scratch_[number];
+		}
+
+		/// \brief true if module number is executed in the run
+		///
+		/// In demand driven chains, modules whose outputs nobody needs in
+		/// the run are skipped. A module can skip the modules that depend
+		/// on it with module_base::skip_rest().
+		bool is_demanded(std::size_t number)const noexcept{
+			return demanded_[number].load(std::memory_order_relaxed);
+		}
+
+		/// \brief Set if module number is executed in the run
+		///
+		/// Modules of the same run may call it concurrently.
+		void set_demanded(std::size_t number, bool demanded)noexcept{
+			demanded_[number].store(demanded, std::memory_order_relaxed);
+		}
+
+		/// \brief Memory for data that does not outlive the run
+		///
+		/// Deallocation is a no-op, everything is released when the run is
+		/// done. Modules of the same run may allocate concurrently.
+		std::pmr::memory_resource& memory()noexcept{ return memory_; }
+
+		/// \brief Time since the run did start
+		clock::duration elapsed()const{ return clock::now() - start; }
+
+
+		/// \brief The id of the run
+		std::size_t const id;
+
+		/// \brief The continuous index of the run in its chain
+		std::size_t const run;
+
+		/// \brief Time when the run did start
+		clock::time_point const start;
+
+
+	private:
+		/// \brief Thread safe monotonic arena
+		class arena: public std::pmr::memory_resource{
+		public:
+			/// \brief Use buffer first, then the default resource
+			arena(void* buffer, std::size_t size)noexcept:
+				resource_(buffer, size) {}
+
+		private:
+			void* do_allocate(std::size_t bytes, std::size_t align)override;
+
+			void do_deallocate(void*, std::size_t, std::size_t)override{}
+
+			bool do_is_equal(
+				std::pmr::memory_resource const& other
+			)const noexcept override{
+				return this == &other;
+			}
+
+			/// \brief Protects resource_
+			std::mutex mutex_;
+
+			/// \brief The arena
+			std::pmr::monotonic_buffer_resource resource_;
+		};
+
+
+		/// \brief First memory of the arena, most runs need no more
+		alignas(std::max_align_t) std::byte buffer_[512];
+
+		/// \brief The arena of the run
+		arena memory_;
+
+		/// \brief One scratch slot per module
+		std::pmr::vector< std::any > scratch_;
+
+		/// \brief One flag per module, true if the module is executed
+		std::pmr::vector< std::atomic< bool > > demanded_;
+	};
+
+
+	/// \brief Makes a context the current context of the calling thread
+	///        or of a module
+	///
+	/// The previous context is restored by the destructor.
+	class exec_context_scope{
+	public:
+		/// \brief Set context as current context of the calling thread
+		exec_context_scope(exec_context& context)noexcept;
+
+		/// \brief Set context as the value of current
+		exec_context_scope(
+			exec_context*& current,
+			exec_context& context
+		)noexcept:
+			current_(current),
+			previous_(current)
+		{
+			current_ = &context;
+		}
+
+		/// \brief Restore the previous context
+		~exec_context_scope(){
+			current_ = previous_;
+		}
+
+
+		/// \brief Scopes are not copyable
+		exec_context_scope(exec_context_scope const&) = delete;
+
+		/// \brief Scopes are not copyable
+		exec_context_scope& operator=(exec_context_scope const&) = delete;
+
+
+	private:
+		/// \brief The replaced context
+		exec_context*& current_;
+
+		/// \brief The context before
+		exec_context* const previous_;
+	};
+
+
+}
+
+
+#endif
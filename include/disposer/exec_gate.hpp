@@ -0,0 +1,131 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__exec_gate__hpp_INCLUDED_
+#define _disposer__exec_gate__hpp_INCLUDED_
+
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <condition_variable>
+
+
+namespace disposer{
+
+
+	/// \brief Lets runs enter a chain while it is enabled
+	///
+	/// The open flag and the count of active runs share one atomic word.
+	/// Entering is one atomic increment, leaving an open gate is one
+	/// compare and swap. Only leaving while close() waits takes the mutex
+	/// to wake the closing thread, so enable and disable are the only
+	/// operations that pay for blocking.
+	class exec_gate{
+	public:
+		/// \brief Keeps the gate from closing while it exists
+		class pass{
+		public:
+			/// \brief Try to enter gate
+			explicit pass(exec_gate& gate)noexcept:
+				gate_(gate.enter() ? &gate : nullptr) {}
+
+			/// \brief Take over the pass of other
+			pass(pass&& other)noexcept:
+				gate_(other.gate_) { other.gate_ = nullptr; }
+
+			/// \brief Leave the gate
+			~pass(){ if(gate_) gate_->leave(); }
+
+
+			/// \brief Passes are not copyable
+			pass(pass const&) = delete;
+
+			/// \brief Passes are not copyable
+			pass& operator=(pass const&) = delete;
+
+			/// \brief Passes are not assignable
+			pass& operator=(pass&&) = delete;
+
+
+			/// \brief true if the gate was open
+			explicit operator bool()const noexcept{ return gate_ != nullptr; }
+
+
+		private:
+			/// \brief The gate or nullptr if it was closed
+			exec_gate* gate_;
+		};
+
+
+		/// \brief The gate is closed initially
+		exec_gate()noexcept: state_(closed_bit) {}
+
+
+		/// \brief Gates are not copyable
+		exec_gate(exec_gate const&) = delete;
+
+		/// \brief Gates are not movable
+		exec_gate(exec_gate&&) = delete;
+
+
+		/// \brief Gates are not copyable
+		exec_gate& operator=(exec_gate const&) = delete;
+
+		/// \brief Gates are not movable
+		exec_gate& operator=(exec_gate&&) = delete;
+
+
+		/// \brief true if runs can enter
+		bool is_open()const noexcept{
+			return (state_.load(std::memory_order_acquire) & closed_bit) == 0;
+		}
+
+		/// \brief Let runs enter
+		void open()noexcept{
+			state_.fetch_and(~closed_bit, std::memory_order_release);
+		}
+
+		/// \brief Let no more runs enter and wait until all active runs
+		///        did leave
+		void close();
+
+
+	private:
+		/// \brief Marks a closed gate, the other bits count the active runs
+		static constexpr std::size_t closed_bit =
+			~(std::numeric_limits< std::size_t >::max() >> 1);
+
+
+		/// \brief Register a run, returns false if the gate is closed
+		bool enter()noexcept{
+			if(state_.fetch_add(1, std::memory_order_acquire) & closed_bit){
+				leave();
+				return false;
+			}
+			return true;
+		}
+
+		/// \brief Unregister a run
+		void leave()noexcept;
+
+
+		/// \brief Closed flag and count of active runs
+		std::atomic< std::size_t > state_;
+
+		/// \brief Protects the wake up of the closing thread
+		std::mutex mutex_;
+
+		/// \brief The closing thread waits for the last run
+		std::condition_variable cv_;
+	};
+
+
+}
+
+
+#endif
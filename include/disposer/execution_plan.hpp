@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__execution_plan__hpp_INCLUDED_
+#define _disposer__execution_plan__hpp_INCLUDED_
+
+#include "module_ptr.hpp"
+#include "merge.hpp"
+
+#include <boost/range/iterator_range.hpp>
+
+#include <memory_resource>
+#include <vector>
+
+
+namespace disposer{
+
+
+	class input_base;
+
+
+	/// \brief Everything a chain needs to execute a run
+	///
+	/// The plan is built once when the chain is constructed and never
+	/// changes afterwards. All lists are contiguous arrays, the steps of a
+	/// module refer to their parts by index, so a run only walks flat
+	/// memory.
+	class execution_plan{
+	public:
+		/// \brief An input that reads a variable of a module
+		struct consumer{
+			/// \brief Number of the reading module
+			std::size_t module;
+
+			/// \brief Index of the input of the first replica in the input
+			///        list of the plan
+			std::size_t first_input;
+		};
+
+		/// \brief One module of the chain
+		struct step{
+			/// \brief Index of the first replica in the module list
+			std::size_t first_replica;
+
+			/// \brief Count of replicas of the module
+			std::size_t replica_count;
+
+			/// \brief Count of modules the module depends on
+			std::size_t dependency_count;
+
+			/// \brief Range of the modules that depend on the module in
+			///        the successor list
+			std::size_t first_successor;
+			std::size_t successor_end;
+
+			/// \brief Range of the inputs that read variables of the module
+			///        in the consumer list
+			std::size_t first_consumer;
+			std::size_t consumer_end;
+
+			/// \brief true if the module processes the runs in run order
+			bool ordered;
+		};
+
+
+		/// \brief Build the plan
+		///
+		/// modules must be created and connected from config_chain. The
+		/// lists of the plan are allocated from resource.
+		///
+		/// Without relaxed_order all modules are ordered. Otherwise only
+		/// modules whose variables nobody reads and modules with the chain
+		/// module parameter 'ordered = true' are ordered.
+		execution_plan(
+			types::merge::chain const& config_chain,
+			std::vector< module_replicas > const& modules,
+			std::pmr::memory_resource& resource,
+			bool relaxed_order = false
+		);
+
+
+		/// \brief Count of modules
+		std::size_t size()const noexcept{ return steps_.size(); }
+
+		/// \brief Product of the id_increase of all modules
+		std::size_t id_increase()const noexcept{ return id_increase_; }
+
+
+		/// \brief The step of module i
+		step const& operator[](std::size_t i)const noexcept{
+			return steps_[i];
+		}
+
+		/// \brief The replica of module i that processes run
+		module_base& module(std::size_t i, std::size_t run)const noexcept{
+			auto const& step = steps_[i];
+			return *modules_[step.first_replica + run % step.replica_count];
+		}
+
+		/// \brief The input of consumer in the replica that processes run
+		input_base& input(consumer const& consumer, std::size_t run)
+		const noexcept{
+			auto const replicas = steps_[consumer.module].replica_count;
+			return *inputs_[consumer.first_input + run % replicas];
+		}
+
+
+		/// \brief Modules that depend on no other module
+		boost::iterator_range< std::size_t const* > roots()const noexcept{
+			return {roots_.data(), roots_.data() + roots_.size()};
+		}
+
+		/// \brief Modules that depend on module i
+		///
+		/// A module depends on the modules that produce its input
+		/// variables. The module that gets a variable with last use also
+		/// depends on the other modules that read this variable.
+		boost::iterator_range< std::size_t const* >
+		successors(std::size_t i)const noexcept{
+			auto const& step = steps_[i];
+			return {
+				successors_.data() + step.first_successor,
+				successors_.data() + step.successor_end
+			};
+		}
+
+		/// \brief Inputs that read variables of module i
+		///
+		/// A reading module always comes after module i in the chain.
+		boost::iterator_range< consumer const* >
+		consumers(std::size_t i)const noexcept{
+			auto const& step = steps_[i];
+			return {
+				consumers_.data() + step.first_consumer,
+				consumers_.data() + step.consumer_end
+			};
+		}
+
+
+	private:
+		/// \brief One step per module in chain order
+		std::pmr::vector< step > steps_;
+
+		/// \brief The replicas of all modules
+		std::pmr::vector< module_base* > modules_;
+
+		/// \brief The successors of all modules
+		std::pmr::vector< std::size_t > successors_;
+
+		/// \brief The consumers of all modules
+		std::pmr::vector< consumer > consumers_;
+
+		/// \brief Per consumer the input of every replica
+		std::pmr::vector< input_base* > inputs_;
+
+		/// \brief Modules that depend on no other module
+		std::pmr::vector< std::size_t > roots_;
+
+		/// \brief Product of the id_increase of all modules
+		std::size_t id_increase_;
+	};
+
+
+}
+
+
+#endif
@@ -12,9 +12,23 @@
 #include "container_lists.hpp"
 #include "input_base.hpp"
 #include "input_data.hpp"
+#include "input_view.hpp"
+#include "data_pool.hpp"
+#include "memory_resources.hpp"
+#include "type_position.hpp"
+#include "exec_context.hpp"
 #include "are_types_distinct.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <variant>
+#include <optional>
+#include <string>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <tuple>
+#include <mutex>
 #include <set>
 #include <map>
 
@@ -25,6 +39,17 @@ namespace disposer{
 	using boost::typeindex::type_id_with_cvr;
 
 
+	/// \brief A module input
+	///
+	/// The data of a run goes to one of a small ring of slots, selected by
+	/// the run index. Every run has exactly one producer thread that writes
+	/// its slot, and the consuming module reads it after the producer is
+	/// done, so only the claim of a slot is an atomic operation. If the
+	/// slot is still owned by another run, the data goes to a mutex
+	/// protected overflow list.
+	///
+	/// Slots and overflow keep one list per input type, so get< V >()
+	/// needs no std::variant.
 	template < typename T, typename ... U >
 	class input: public input_base{
 	public:
@@ -59,17 +84,82 @@ namespace disposer{
 		using input_base::input_base;
 
 
-		std::multimap< std::size_t, value_type > get(){
-			std::lock_guard< std::mutex > lock(mutex_);
-			auto from = data_.begin();
-			auto to = data_.upper_bound(id);
+		/// \brief Get the data of the actual and all previous runs
+		///
+		/// The data is ordered by id. The view is valid until its
+		/// destruction or the next get() call. After the first runs, no
+		/// memory is allocated.
+		///
+		/// With more than one input type, the data of all types is merged
+		/// into a list of std::variant's. get< V >() and for_each< V >()
+		/// access the data of one type without that.
+		input_view< value_type > get(){
+			if constexpr(sizeof...(U) == 0){
+				return this->template get< T >();
+			}else{
+				take_once();
+
+				buffer_.clear();
+				hana::for_each(value_types, [this](auto type){
+					using V = typename decltype(type)::type;
+					auto& list = std::get< typed_list< V > >(buffers_);
+					for(auto& [id, data]: list){
+						buffer_.emplace_back(id, std::move(data));
+					}
+					list.clear();
+				});
+				sort_by_id(buffer_);
+
+				return input_view< value_type >(buffer_);
+			}
+		}
 
-			std::multimap< std::size_t, value_type > result(
-				std::make_move_iterator(from), std::make_move_iterator(to)
+		/// \brief Get the data of type V of the actual and all previous
+		///        runs
+		///
+		/// The data is ordered by id. The view is valid until its
+		/// destruction or the next get< V >() call.
+		template < typename V >
+		input_view< input_data< V > > get(){
+			static_assert(
+				hana::contains(value_types, hana::type_c< V >),
+				"type V in get< V > is not an input type"
 			);
-			data_.erase(from, to);
 
-			return result;
+			take_once();
+			return input_view< input_data< V > >(
+				std::get< typed_list< V > >(buffers_));
+		}
+
+		/// \brief Get the data of the actual run, there must be exactly one
+		///
+		/// If the producing module puts one id per run, the data is taken
+		/// directly from the slot of the run in O(1). Otherwise, or if there
+		/// is more data, get() is used. Throws if the input has not exactly
+		/// one data.
+		value_type get_one(){
+			auto const run = run_context().run;
+			if(
+				single_value_ && taken_ != run + 1 &&
+				overflow_count_.load(std::memory_order_acquire) == 0
+			){
+				if(auto result = take_single(run)) return std::move(*result);
+			}
+
+			auto data = get();
+			if(data.size() != 1){
+				throw std::logic_error("input '" + name + "' got " +
+					std::to_string(data.size()) +
+					" data, but get_one() expects exactly one");
+			}
+
+			return std::move(data[0].second);
+		}
+
+		/// \brief Call fn(id, data) for the data of type V in id order
+		template < typename V, typename F >
+		void for_each(F&& fn){
+			for(auto& [id, data]: this->template get< V >()) fn(id, data);
 		}
 
 		std::vector< type_index > active_types()const{
@@ -105,30 +195,81 @@ namespace disposer{
 
 
 	private:
-		virtual void add(
-			std::size_t id,
-			any_type const& value,
-			type_index const& type,
-			bool last_use
+		/// \brief Number of slots in the ring without set_slot_count()
+		static constexpr std::size_t default_slot_count = 8;
+
+		/// \brief A list of id and data pairs
+		using data_list = typename input_view< value_type >::list;
+
+		/// \brief A list of id and data pairs of type V
+		template < typename V >
+		using typed_list = typename input_view< input_data< V > >::list;
+
+		/// \brief One list per input type
+		using typed_lists = std::tuple< typed_list< T >, typed_list< U > ... >;
+
+		/// \brief A list of run, id and data of type V
+		template < typename V >
+		using overflow_list = std::pmr::vector<
+			std::tuple< std::size_t, std::size_t, input_data< V > > >;
+
+		/// \brief The data of one run
+		struct slot{
+			/// \brief run + 1 of the owning run, 0 if the slot is free
+			std::atomic< std::size_t > owner{0};
+
+			/// \brief The first data of the owning run, if the input
+			///        expects one data per run
+			std::optional< std::pair< std::size_t, value_type > > one;
+
+			/// \brief The data of the owning run
+			typed_lists data;
+		};
+
+
+		virtual void use_data_pools(
+			data_pools& pools,
+			std::pmr::memory_resource& resource
 		)override{
-			auto iter = type_map_.find(type);
-			if(iter == type_map_.end()){
-				throw std::logic_error(
-					"unknown add type '" + type.pretty_name() +
-					"' in input + '" + name + "'"
-				);
+			pools_ = {{
+				pools.get(type_id_with_cvr< T >(), resource),
+				pools.get(type_id_with_cvr< U >(), resource) ...
+			}};
+
+			// the lists are still empty
+			resource_ = &resource;
+			for(std::size_t i = 0; i < slot_count_; ++i){
+				use_resource(slots_[i].data, resource);
+			}
+			use_resource(overflow_, resource);
+			use_resource(buffers_, resource);
+			use_memory_resource(buffer_, resource);
+		}
+
+		virtual void use_slot_count(std::size_t count)override{
+			slot_count_ = std::max< std::size_t >(count, 1);
+			slots_ = std::make_unique< slot[] >(slot_count_);
+
+			if(resource_ == nullptr) return;
+			for(std::size_t i = 0; i < slot_count_; ++i){
+				use_resource(slots_[i].data, *resource_);
 			}
+		}
 
-			// Call add< type >(id, value, last_use)
-			(this->*(iter->second))(id, value, last_use);
+		virtual entry_points entry_points_for(
+			type_index const& type,
+			bool last_use
+		)const noexcept override{
+			auto iter = type_map_.find(type);
+			if(iter == type_map_.end()) return {nullptr, nullptr};
+			return iter->second[last_use ? 1 : 0];
 		}
 
 
-		virtual void cleanup(std::size_t id)noexcept override{
-			std::lock_guard< std::mutex > lock(mutex_);
-			auto from = data_.begin();
-			auto to = data_.upper_bound(id);
-			data_.erase(from, to);
+		virtual void cleanup(std::size_t run)noexcept override{
+			clear_buffers();
+			take(run);
+			clear_buffers();
 		}
 
 		virtual std::vector< type_index > types()const override{
@@ -155,39 +296,333 @@ namespace disposer{
 		}
 
 
+		/// \brief The add_function for type V and last_use
+		template < typename V, bool LastUse >
+		static void typed_add(
+			input_base& base,
+			std::size_t run,
+			std::size_t id,
+			any_type const& value
+		){
+			static_cast< input& >(base).add< V >(run, id, value, LastUse);
+		}
+
+		/// \brief The add_range_function for type V and last_use
+		template < typename V, bool LastUse >
+		static void typed_add_range(
+			input_base& base,
+			std::size_t run,
+			std::size_t first_id,
+			any_type const* values,
+			std::size_t count
+		){
+			static_cast< input& >(base).add_range< V >(
+				run, first_id, values, count, LastUse);
+		}
+
+		/// \brief The entry points for type V without and with last_use
+		template < typename V >
+		static constexpr std::array< entry_points, 2 > typed_entry_points{{
+			{&typed_add< V, false >, &typed_add_range< V, false >},
+			{&typed_add< V, true >, &typed_add_range< V, true >}
+		}};
+
+		/// \brief Get the slot of run, nullptr if another run owns it
+		slot* claim_slot(std::size_t run)noexcept{
+			auto& slot = slots_[run % slot_count_];
+			auto owner = slot.owner.load(std::memory_order_acquire);
+			if(owner == 0){
+				// take the free slot, or get the run that was faster
+				if(slot.owner.compare_exchange_strong(owner, run + 1,
+					std::memory_order_acquire
+				)) owner = run + 1;
+			}
+
+			return owner == run + 1 ? &slot : nullptr;
+		}
+
+		template < typename V >
+		void add(
+			std::size_t run,
+			std::size_t id,
+			any_type const& value,
+			bool last_use
+		){
+			auto const& data =
+				reinterpret_cast< signal_data_t< V > const& >(value);
+			auto const pool = &pools_[type_position_v< V, T, U ... >];
+
+			if(auto const slot = claim_slot(run)){
+				if(single_value_ && !slot->one){
+					slot->one.emplace(
+						id, input_data< V >(data, last_use, pool));
+				}else{
+					std::get< typed_list< V > >(slot->data).emplace_back(
+						id, input_data< V >(data, last_use, pool));
+				}
+				return;
+			}
+
+			// the slot is owned by another run
+			std::lock_guard< std::mutex > lock(overflow_mutex_);
+			std::get< overflow_list< V > >(overflow_).emplace_back(
+				run, id, input_data< V >(data, last_use, pool));
+			overflow_count_.fetch_add(1, std::memory_order_release);
+		}
+
 		template < typename V >
-		void add(std::size_t id, any_type const& value, bool last_use){
-			auto data = reinterpret_cast< output_data_ptr< V > const& >(value);
+		void add_range(
+			std::size_t run,
+			std::size_t first_id,
+			any_type const* values,
+			std::size_t count,
+			bool last_use
+		){
+			auto const data =
+				reinterpret_cast< signal_data_t< V > const* >(values);
+			auto const pool = &pools_[type_position_v< V, T, U ... >];
+
+			if(auto const slot = claim_slot(run)){
+				auto& list = std::get< typed_list< V > >(slot->data);
+				list.reserve(list.size() + count);
+				for(std::size_t i = 0; i < count; ++i){
+					list.emplace_back(first_id + i,
+						input_data< V >(data[i], last_use, pool));
+				}
+				return;
+			}
+
+			// the slot is owned by another run
+			std::lock_guard< std::mutex > lock(overflow_mutex_);
+			auto& overflow = std::get< overflow_list< V > >(overflow_);
+			for(std::size_t i = 0; i < count; ++i){
+				overflow.emplace_back(run, first_id + i,
+					input_data< V >(data[i], last_use, pool));
+			}
+			overflow_count_.fetch_add(count, std::memory_order_release);
+		}
 
-			std::lock_guard< std::mutex > lock(mutex_);
-			data_.emplace(id, input_data< V >(data, last_use));
+		/// \brief Move the data of the actual run to buffers_, if not
+		///        done yet
+		///
+		/// Data that was not got in the last run is dropped.
+		void take_once(){
+			auto const run = run_context().run;
+			if(taken_ == run + 1) return;
+
+			clear_buffers();
+			take(run);
+			taken_ = run + 1;
 		}
 
+		/// \brief Take the single data of run without buffers_
+		///
+		/// Like take_once(), but only if run has exactly one data and no
+		/// previous run has data left. Returns an empty optional and takes
+		/// nothing otherwise.
+		std::optional< value_type > take_single(std::size_t run){
+			auto& slot = slots_[run % slot_count_];
+			if(
+				slot.owner.load(std::memory_order_acquire) != run + 1 ||
+				!slot.one || !lists_empty(slot.data)
+			) return {};
+
+			// get() would return the data of previous runs too
+			if(!exact_run_){
+				for(std::size_t i = 1; i < slot_count_; ++i){
+					auto const owner = slots_[(run + i) % slot_count_]
+						.owner.load(std::memory_order_acquire);
+					if(owner != 0 && owner <= run) return {};
+				}
+			}
+
+			clear_buffers();
+			taken_ = run + 1;
 
-		static std::map<
-			type_index, void(input::*)(std::size_t, any_type const&, bool)
-		> const type_map_;
+			std::optional< value_type > result(std::move(slot.one->second));
+			slot.one.reset();
+			slot.owner.store(0, std::memory_order_release);
+			return result;
+		}
+
+		/// \brief Move the data of run and all previous runs to buffers_
+		///
+		/// With exact_run_ only the data of run is moved.
+		void take(std::size_t run){
+			// the slots from the oldest to the actual run
+			for(std::size_t i = 1; i <= slot_count_; ++i){
+				auto& slot = slots_[(run + i) % slot_count_];
+
+				auto const owner = slot.owner.load(std::memory_order_acquire);
+				if(owner == 0 || owner > run + 1) continue;
+				if(exact_run_ && owner != run + 1) continue;
+
+				hana::for_each(value_types, [this, &slot](auto type){
+					using V = typename decltype(type)::type;
+					move_list(
+						std::get< typed_list< V > >(slot.data),
+						std::get< typed_list< V > >(buffers_));
+				});
+				take_one(slot);
+
+				slot.owner.store(0, std::memory_order_release);
+			}
+
+			if(overflow_count_.load(std::memory_order_acquire) > 0){
+				std::lock_guard< std::mutex > lock(overflow_mutex_);
+				std::size_t count = 0;
+				hana::for_each(value_types, [this, run, &count](auto type){
+					using V = typename decltype(type)::type;
+					auto& overflow = std::get< overflow_list< V > >(overflow_);
+					auto& buffer = std::get< typed_list< V > >(buffers_);
+
+					auto const end = std::stable_partition(
+						overflow.begin(), overflow.end(),
+						[this, run](auto const& entry){
+							auto const entry_run = std::get< 0 >(entry);
+							return exact_run_
+								? entry_run != run
+								: entry_run > run;
+						});
+
+					for(auto iter = end; iter != overflow.end(); ++iter){
+						buffer.emplace_back(std::get< 1 >(*iter),
+							std::move(std::get< 2 >(*iter)));
+					}
+
+					overflow.erase(end, overflow.end());
+					count += overflow.size();
+				});
+				overflow_count_.store(count, std::memory_order_release);
+			}
+
+			// data of older runs or overflow data might be out of order
+			std::apply([](auto& ... list){
+				(sort_by_id(list), ...);
+			}, buffers_);
+		}
+
+		/// \brief Move the single data of slot to buffers_
+		void take_one(slot& slot){
+			if(!slot.one) return;
+
+			auto const id = slot.one->first;
+			if constexpr(sizeof...(U) == 0){
+				std::get< 0 >(buffers_).emplace_back(
+					id, std::move(slot.one->second));
+			}else{
+				std::visit([this, id](auto& data){
+					using list = typename input_view<
+						std::decay_t< decltype(data) > >::list;
+					std::get< list >(buffers_).emplace_back(
+						id, std::move(data));
+				}, slot.one->second);
+			}
+
+			slot.one.reset();
+		}
+
+		/// \brief true if all lists are empty
+		static bool lists_empty(typed_lists const& lists)noexcept{
+			return std::apply([](auto const& ... list){
+				return (list.empty() && ...);
+			}, lists);
+		}
+
+		/// \brief Let all lists of a tuple use resource
+		template < typename ... Lists >
+		static void use_resource(
+			std::tuple< Lists ... >& lists,
+			std::pmr::memory_resource& resource
+		){
+			std::apply([&resource](auto& ... list){
+				(use_memory_resource(list, resource), ...);
+			}, lists);
+		}
+
+		/// \brief Remove the data of all buffers
+		void clear_buffers()noexcept{
+			std::apply([](auto& ... list){ (list.clear(), ...); }, buffers_);
+			buffer_.clear();
+		}
+
+		/// \brief Append the data of from to to
+		template < typename List >
+		static void move_list(List& from, List& to){
+			if(to.empty()){
+				// keep the memory of the buffer for the slot
+				to.swap(from);
+			}else{
+				std::move(from.begin(), from.end(), std::back_inserter(to));
+				from.clear();
+			}
+		}
+
+		/// \brief Sort list stable by id
+		template < typename List >
+		static void sort_by_id(List& list){
+			auto const less = [](auto const& a, auto const& b){
+				return a.first < b.first;
+			};
+
+			if(!std::is_sorted(list.begin(), list.end(), less)){
+				std::stable_sort(list.begin(), list.end(), less);
+			}
+		}
+
+
+		/// \brief Entry points of all input types, only used to connect
+		static std::map< type_index, std::array< entry_points, 2 > > const
+			type_map_;
 
 		std::map< type_index, bool > active_map_ = {
 			{ type_id_with_cvr< T >(), false },
 			{ type_id_with_cvr< U >(), false } ...
 		};
 
-		std::mutex mutex_;
+		/// \brief Per input type the pool for copies of the data
+		std::array< data_pool_ptr, 1 + sizeof...(U) > pools_;
+
+		/// \brief Number of slots in the ring
+		std::size_t slot_count_ = default_slot_count;
+
+		/// \brief Ring of per run slots
+		std::unique_ptr< slot[] > slots_ =
+			std::make_unique< slot[] >(default_slot_count);
+
+		/// \brief Resource of the lists, nullptr before use_data_pools()
+		std::pmr::memory_resource* resource_ = nullptr;
+
+		/// \brief Protects overflow_
+		std::mutex overflow_mutex_;
+
+		/// \brief Size of overflow_, get() locks only if it is not 0
+		std::atomic< std::size_t > overflow_count_{0};
+
+		/// \brief Per type the data whose slot was owned by another run
+		std::tuple< overflow_list< T >, overflow_list< U > ... > overflow_;
+
+		/// \brief Per type the data of the actual run
+		typed_lists buffers_;
+
+		/// \brief The merged data of the last get() call with more than
+		///        one input type
+		data_list buffer_;
 
-		std::multimap< std::size_t, value_type > data_;
+		/// \brief run + 1 of the last run whose data was taken
+		std::size_t taken_ = 0;
 	};
 
 	template < typename T, typename ... U >
 	class input< type_list< T, U ... > >: public input< T, U ... >{};
 
 	template < typename T, typename ... U >
-	std::map<
-		type_index,
-		void(input< T, U ... >::*)(std::size_t, any_type const&, bool)
-	> const input< T, U ... >::type_map_ = {
-			{ type_id_with_cvr< T >(), &input< T, U ... >::add< T > },
-			{ type_id_with_cvr< U >(), &input< T, U ... >::add< U > } ...
+	std::map< type_index, std::array< input_base::entry_points, 2 > > const
+		input< T, U ... >::type_map_ = {
+			{ type_id_with_cvr< T >(),
+				input< T, U ... >::typed_entry_points< T > },
+			{ type_id_with_cvr< U >(),
+				input< T, U ... >::typed_entry_points< U > } ...
 		};
 
 	template <
@@ -10,13 +10,16 @@
 #define _disposer__input_base__hpp_INCLUDED_
 
 #include "disposer.hpp"
+#include "exec_context.hpp"
 
 #include <boost/type_index.hpp>
 
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <functional>
 #include <unordered_map>
+#include <memory_resource>
 
 
 namespace disposer{
@@ -25,9 +28,12 @@ namespace disposer{
 	using boost::typeindex::type_index;
 
 
-	/// \brief Dummy type for references to real data in inputs and outputs
+	/// \brief Dummy type for references to the signal_data_t of real data in
+	///        inputs and outputs
 	struct any_type;
 
+	class data_pools;
+
 
 	/// \brief Class module_base access key
 	struct module_base_key{
@@ -69,8 +75,41 @@ namespace disposer{
 	/// An input might have more then one data type.
 	class input_base{
 	public:
+		/// \brief Entry point to add data of one type to an input
+		///
+		/// The last_use flag is part of the entry point.
+		using add_function = void(*)(
+			input_base& input,
+			std::size_t run,
+			std::size_t id,
+			any_type const& value
+		);
+
+		/// \brief Entry point to add the data of count successive ids to an
+		///        input
+		///
+		/// values points to the first element of an array of count
+		/// signal_data_t's.
+		using add_range_function = void(*)(
+			input_base& input,
+			std::size_t run,
+			std::size_t first_id,
+			any_type const* values,
+			std::size_t count
+		);
+
+		/// \brief The entry points of one type
+		struct entry_points{
+			add_function add;
+			add_range_function add_range;
+		};
+
+		/// \brief Tells if the input needs the data of the run with id
+		using demand_function = std::function< bool(std::size_t id) >;
+
+
 		/// \brief Constructor
-		input_base(std::string const& name): name(name), id(id_), id_(0) {}
+		input_base(std::string const& name): name(name) {}
 
 
 		/// \brief Inputs are not copyable
@@ -101,21 +140,91 @@ namespace disposer{
 		) noexcept{ return enable_types(types); }
 
 
-		/// \brief Call add(id, value, type, last_use)
-		void add(
+		/// \brief Call use_data_pools(pools, resource)
+		void set_data_pools(
+			creator_key,
+			data_pools& pools,
+			std::pmr::memory_resource& resource
+		){
+			use_data_pools(pools, resource);
+		}
+
+
+		/// \brief Call use_slot_count(count)
+		///
+		/// count is the number of overlapping runs whose data the input
+		/// holds without lock, more runs use the locked overflow list.
+		/// Must be called before data is added.
+		void set_slot_count(creator_key, std::size_t count){
+			use_slot_count(count);
+		}
+
+
+		/// \brief Set if the producing module puts one id per run
+		void set_single_value(creator_key, bool single_value)noexcept{
+			single_value_ = single_value;
+		}
+
+
+		/// \brief Set if the input gets only the data of the actual run
+		///
+		/// In chains with relaxed run order, a run may overtake another, so
+		/// the data of older runs belongs to them.
+		void set_exact_run(creator_key, bool exact_run)noexcept{
+			exact_run_ = exact_run;
+		}
+
+		/// \brief Set the number of the module that owns the input
+		void set_module_number(creator_key, std::size_t number)noexcept{
+			module_number_ = number;
+		}
+
+		/// \brief Set the context of the run the owning module processes
+		///
+		/// context is a member of the module, it is set while the module
+		/// processes a run.
+		void set_module_context(
+			creator_key,
+			exec_context* const& context
+		)noexcept{
+			module_context_ = &context;
+		}
+
+
+		/// \brief Set the demand of the input
+		///
+		/// In demand driven chains the function is called at the start of
+		/// every run, possibly concurrently for different runs. If no input
+		/// of a module demands data, the producing modules are skipped.
+		/// Without demand function the input needs the data of every run.
+		void set_demand(demand_function demand){
+			demand_ = std::move(demand);
+		}
+
+		/// \brief true if the input needs the data of the run with id
+		bool demands(std::size_t id)const{
+			return !demand_ || demand_(id);
+		}
+
+		/// \brief true if the module of the input is executed in the
+		///        run of context and the input needs the data of the run
+		bool is_demanded(exec_context const& context)const{
+			return context.is_demanded(module_number_) && demands(context.id);
+		}
+
+
+		/// \brief Call entry_points_for(type, last_use)
+		entry_points get_entry_points(
 			signal_t_key,
-			std::size_t id,
-			any_type const& value,
 			type_index const& type,
 			bool last_use
-		){ add(id, value, type, last_use); }
+		)const noexcept{ return entry_points_for(type, last_use); }
 
 
-		/// \brief Set the new id for the next exec or cleanup
-		void set_id(module_base_key, std::size_t id)noexcept{ id_ = id; }
-
-		/// \brief Call cleanup(id)
-		void cleanup(module_base_key, std::size_t id)noexcept{ cleanup(id); }
+		/// \brief Call cleanup(run)
+		void cleanup(module_base_key, std::size_t run)noexcept{
+			cleanup(run);
+		}
 
 
 
@@ -124,13 +233,54 @@ namespace disposer{
 
 
 	protected:
-		/// \brief Add data to an input
-		virtual void add(
-			std::size_t id,
-			any_type const& value,
+		/// \brief true if the producing module has an id_increase of 1
+		///
+		/// The input then expects one data per run.
+		bool single_value_ = false;
+
+		/// \brief true if get() and cleanup() use only the data of the
+		///        actual run, not of previous runs
+		bool exact_run_ = false;
+
+		/// \brief Number of the module that owns the input
+		std::size_t module_number_ = 0;
+
+		/// \brief The context of the run the owning module processes
+		exec_context* const* module_context_ = nullptr;
+
+		/// \brief Tells if the input needs the data of a run
+		demand_function demand_;
+
+
+		/// \brief The context of the run the owning module processes
+		///
+		/// Without module it is the current context of the calling thread.
+		/// Throws if there is none.
+		exec_context& run_context()const{
+			if(module_context_ && *module_context_) return **module_context_;
+			return exec_context::get();
+		}
+
+
+		/// \brief Get the pools for copies of the input types
+		///
+		/// The internal lists of the input use resource. Called before the
+		/// input is connected.
+		virtual void use_data_pools(
+			data_pools& pools,
+			std::pmr::memory_resource& resource
+		) = 0;
+
+		/// \brief Hold the data of count runs without lock
+		virtual void use_slot_count(std::size_t count) = 0;
+
+		/// \brief The entry points to add data of type with last_use
+		///
+		/// Returns nullptr's if type is not an input type.
+		virtual entry_points entry_points_for(
 			type_index const& type,
 			bool last_use
-		) = 0;
+		)const noexcept = 0;
 
 
 		/// \brief Enable the given types
@@ -140,17 +290,10 @@ namespace disposer{
 
 
 
-		/// \brief Clean up all data with ID less or equal id
-		virtual void cleanup(std::size_t id)noexcept = 0;
-
-		/// \brief Read only reference to the actual ID while module::exec()
-		///        is running
-		std::size_t const& id;
-
-
-	private:
-		/// \brief The actual ID while module::exec() is running
-		std::size_t id_;
+		/// \brief Clean up all data of run and all previous runs
+		///
+		/// With exact run only the data of run is cleaned up.
+		virtual void cleanup(std::size_t run)noexcept = 0;
 	};
 
 
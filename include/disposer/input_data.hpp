@@ -10,8 +10,10 @@
 #define _disposer__input_data__hpp_INCLUDED_
 
 #include "output_data.hpp"
+#include "data_pool.hpp"
 #include "type_name.hpp"
 
+#include <atomic>
 #include <stdexcept>
 
 
@@ -19,26 +21,73 @@ namespace disposer{
 
 
 	/// \brief Wrapper for input data
+	///
+	/// If is_inline_data_v< T > is true, the input has its own copy of the
+	/// data, otherwise it shares the data with the other inputs.
 	template < typename T >
 	class input_data{
 	public:
 		/// \brief Constructor
-		input_data(output_data_ptr< T > const& data, bool last_use):
+		///
+		/// pool is used for copies of the data, it must outlive the object.
+		input_data(
+			signal_data_t< T > const& data,
+			bool last_use,
+			data_pool_ptr const* pool = nullptr
+		):
 			data_(data),
-			last_use_(last_use)
+			last_use_(last_use),
+			pool_(pool)
 			{}
 
 		/// \brief Access the data via const reference
 		T const& data()const{
-			return data_->data();
+			if constexpr(is_inline_data_v< T >){
+				return data_;
+			}else{
+				return data_->data();
+			}
 		}
 
-		/// \brief If last use move out the pointer, otherwise get a deep copy
-		output_data_ptr< T > get(){
-			if(last_use_){
-				return std::move(data_);
+		/// \brief Shared read only access to the data
+		///
+		/// Shares the data without a copy, small data is copied.
+		std::shared_ptr< T const > get_shared()const{
+			if constexpr(is_inline_data_v< T >){
+				return std::make_shared< T const >(data_);
 			}else{
+				return std::shared_ptr< T const >(data_, &data_->data());
+			}
+		}
+
+		/// \brief true if this is the last use of the data in the chain
+		bool last_use()const noexcept{ return last_use_; }
+
+		/// \brief Get the data for exclusive write access
+		///
+		/// Moves out the pointer if nobody else holds the data anymore,
+		/// otherwise get a deep copy. Even with last use, the holders of
+		/// get_shared() pointers keep the data shared.
+		///
+		/// Small data is returned in an inline_data_ptr without heap
+		/// allocation, the input has an own copy of it anyway.
+		exclusive_data_ptr_t< T > get(){
+			if constexpr(is_inline_data_v< T >){
+				return inline_data_ptr< T >(data_);
+			}else{
+				// if use_count is 1, no other thread can get a new reference
+				if(data_.use_count() == 1){
+					// use_count() is a relaxed load, see the reads of the
+					// former holders before their release
+					std::atomic_thread_fence(std::memory_order_acquire);
+					return std::move(data_);
+				}
+
 				if constexpr(std::is_copy_constructible_v< T >){
+					if(pool_ != nullptr){
+						return make_pooled< output_data< T > >(*pool_, data());
+					}
+
 					return std::make_shared< output_data< T > >(data());
 				}else{
 					throw std::logic_error(
@@ -51,11 +100,14 @@ namespace disposer{
 
 
 	private:
-		/// \brief shared_ptr to the data
-		output_data_ptr< T > data_;
+		/// \brief The data or a shared_ptr to the data
+		signal_data_t< T > data_;
 
 		/// \brief Flag if this is the last use of the data in the chain
 		bool last_use_;
+
+		/// \brief Pool for copies of the data or nullptr
+		data_pool_ptr const* pool_;
 	};
 
 
@@ -65,7 +117,9 @@ namespace disposer{
 	public:
 		/// \brief Constructor
 		input_data(
-			output_data_ptr< std::future< T > > const& data, bool last_use
+			output_data_ptr< std::future< T > > const& data,
+			bool last_use,
+			data_pool_ptr const* = nullptr
 		):
 			data_(data),
 			last_use_(last_use)
@@ -76,6 +130,11 @@ namespace disposer{
 			return data_->data();
 		}
 
+		/// \brief Shared read only access to the data without a copy
+		std::shared_ptr< T const > get_shared()const{
+			return std::shared_ptr< T const >(data_, &data_->data());
+		}
+
 		/// \brief Move out the pointer if last use or get a deep copy
 		output_data_ptr< T > get(){
 			if(last_use_){
@@ -105,7 +164,11 @@ namespace disposer{
 	class input_data< std::future< void > >{
 	public:
 		/// \brief Constructor
-		input_data(output_data_ptr< std::future< void > > const& data, bool):
+		input_data(
+			output_data_ptr< std::future< void > > const& data,
+			bool,
+			data_pool_ptr const* = nullptr
+		):
 			data_(data)
 			{}
 
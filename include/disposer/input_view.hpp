@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__input_view__hpp_INCLUDED_
+#define _disposer__input_view__hpp_INCLUDED_
+
+#include <utility>
+#include <memory_resource>
+
+
+namespace disposer{
+
+
+	/// \brief The data of an input for one exec() call
+	///
+	/// The view refers to a buffer owned by the input. The destructor
+	/// clears the buffer, but keeps its memory for the next run.
+	template < typename T >
+	class input_view{
+	public:
+		/// \brief Pairs of id and data
+		using value_type = std::pair< std::size_t, T >;
+
+		/// \brief Type of the buffer
+		using list = std::pmr::vector< value_type >;
+
+		/// \brief Iterator type
+		using iterator = typename list::iterator;
+
+
+		/// \brief Constructor
+		explicit input_view(list& data)noexcept: data_(&data) {}
+
+		/// \brief Move constructor
+		input_view(input_view&& other)noexcept:
+			data_(std::exchange(other.data_, nullptr)) {}
+
+		/// \brief Release the data
+		~input_view(){
+			if(data_ != nullptr) data_->clear();
+		}
+
+
+		/// \brief Views are not copyable
+		input_view(input_view const&) = delete;
+
+		/// \brief Views are not copyable
+		input_view& operator=(input_view const&) = delete;
+
+		/// \brief Views are not assignable
+		input_view& operator=(input_view&&) = delete;
+
+
+		/// \brief First pair of id and data
+		iterator begin()const noexcept{ return data_->begin(); }
+
+		/// \brief Behind the last pair of id and data
+		iterator end()const noexcept{ return data_->end(); }
+
+		/// \brief Count of data
+		std::size_t size()const noexcept{ return data_->size(); }
+
+		/// \brief true if there is no data
+		bool empty()const noexcept{ return data_->empty(); }
+
+		/// \brief Access the i-th pair of id and data
+		value_type& operator[](std::size_t i)const noexcept{
+			return (*data_)[i];
+		}
+
+
+	private:
+		/// \brief The buffer of the input
+		list* data_;
+	};
+
+
+}
+
+
+#endif
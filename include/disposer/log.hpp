@@ -198,12 +198,12 @@ namespace disposer{
 		}
 
 		/// \brief Check if a type has a exec() function
-		auto has_exec = boost::hana::is_valid(
+		inline auto has_exec = boost::hana::is_valid(
 			[](auto&& x)->decltype((void)x->exec()){}
 		);
 
 		/// \brief Check if a type has a have_body() function
-		auto has_have_body = boost::hana::is_valid(
+		inline auto has_have_body = boost::hana::is_valid(
 			[](auto&& x)->decltype((void)x->have_body()){}
 		);
 
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__memory_resources__hpp_INCLUDED_
+#define _disposer__memory_resources__hpp_INCLUDED_
+
+#include <memory_resource>
+#include <string>
+#include <map>
+
+
+namespace disposer{
+
+
+	/// \brief Named memory resources for the config file
+	///
+	/// The resources are not owned, they must outlive the disposer and all
+	/// data that was allocated from them.
+	class memory_resources{
+	public:
+		/// \brief The default resource is std::pmr::get_default_resource()
+		memory_resources()noexcept:
+			default_(std::pmr::get_default_resource()) {}
+
+
+		/// \brief Register resource under name
+		void add(std::string const& name, std::pmr::memory_resource& resource);
+
+		/// \brief Set the resource that is used if none is configured
+		void set_default(std::pmr::memory_resource& resource)noexcept{
+			default_ = &resource;
+		}
+
+
+		/// \brief Get the resource with name
+		///
+		/// An empty name is the default resource. Throws if name is not
+		/// registered.
+		std::pmr::memory_resource& get(std::string const& name)const;
+
+		/// \brief The resource that is used if none is configured
+		std::pmr::memory_resource& get_default()const noexcept{
+			return *default_;
+		}
+
+
+	private:
+		/// \brief The resource that is used if none is configured
+		std::pmr::memory_resource* default_;
+
+		/// \brief Map from name to resource
+		std::map< std::string, std::pmr::memory_resource* > resources_;
+	};
+
+
+	/// \brief Replace the memory resource of an empty pmr container
+	///
+	/// Assignment does not propagate polymorphic allocators, so the
+	/// container is destroyed and constructed again.
+	template < typename Container >
+	void use_memory_resource(
+		Container& container,
+		std::pmr::memory_resource& resource
+	)noexcept{
+		container.~Container();
+		new(&container) Container(
+			typename Container::allocator_type(&resource));
+	}
+
+
+}
+
+
+#endif
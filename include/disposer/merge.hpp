@@ -32,6 +32,7 @@ namespace disposer{
 			std::pair< std::string const, merge::module >& module;
 			std::vector< parse::io > inputs;
 			std::vector< parse::io > outputs;
+			std::map< std::string, std::string > parameters;
 		};
 
 		struct chain{
@@ -39,6 +40,10 @@ namespace disposer{
 			std::string id_generator;
 			std::string group;
 			std::vector< chain_module > modules;
+			std::string memory_resource;
+			std::string max_in_flight;
+			std::string overload_policy;
+			std::string run_order;
 		};
 
 		using chains = std::vector< chain >;
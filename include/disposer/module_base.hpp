@@ -13,6 +13,7 @@
 #include "make_data.hpp"
 #include "output_base.hpp"
 #include "input_base.hpp"
+#include "exec_context.hpp"
 #include "log.hpp"
 
 #include <functional>
@@ -30,6 +31,19 @@ namespace disposer{
 	};
 
 
+	/// \brief How the run continues after the exec() of a module
+	enum class run_status{
+		/// \brief Continue normally
+		proceed,
+
+		/// \brief Skip all modules that depend on the module
+		skip_rest,
+
+		/// \brief Skip all modules that are not yet executed
+		abort_run
+	};
+
+
 	/// \brief Exception class for modules that need input variables
 	struct module_not_as_start: std::logic_error{
 		module_not_as_start(make_data const& data):
@@ -66,6 +80,14 @@ namespace disposer{
 			input_list&& inputs = {}
 		);
 
+		/// \brief Constructor for modules that put id_increase ids per run
+		module_base(
+			make_data const& data,
+			std::size_t id_increase,
+			input_list&& inputs,
+			output_list&& outputs = {}
+		);
+
 		/// \brief Modules are not copyable
 		module_base(module_base const&) = delete;
 
@@ -105,12 +127,21 @@ namespace disposer{
 		}
 
 
-		/// \brief Set for next exec ID
-		void set_id(chain_key, std::size_t id);
-
-
-		/// \brief Call the actual worker function exec()
-		void exec(chain_key){ exec(); }
+		/// \brief Call the actual worker function exec() with context as
+		///        current context
+		///
+		/// The module keeps the context until exec() returns, so threads
+		/// that exec() starts can use the inputs and outputs of the module.
+		///
+		/// Returns how the run continues.
+		run_status exec(chain_key, exec_context& context){
+			exec_context_scope scope(context);
+			exec_context_scope module_scope(context_, context);
+			id_ = context.id;
+			status_ = run_status::proceed;
+			exec();
+			return status_;
+		}
 
 
 		/// \brief Call the actual enable() function
@@ -127,8 +158,8 @@ namespace disposer{
 		/// \brief Called for a modules wich failed by exception and all
 		///        following modules in the chain instead of exec()
 		///
-		/// Removes all input data whichs ID is less or equal to the actual ID.
-		void cleanup(chain_key, std::size_t id)noexcept;
+		/// Removes all input data of the run and all previous runs.
+		void cleanup(chain_key, exec_context const& context)noexcept;
 
 
 		/// \brief Access to internal inputs_
@@ -137,6 +168,12 @@ namespace disposer{
 		/// \brief Access to internal outputs_
 		output_list& outputs(creator_key){ return outputs_; }
 
+		/// \brief The context of the run the module processes, nullptr
+		///        while exec() does not run
+		exec_context* const& context(creator_key)const noexcept{
+			return context_;
+		}
+
 
 		/// \brief Name of the module type given via class module_declarant
 		std::string const type_name;
@@ -176,6 +213,44 @@ namespace disposer{
 		virtual void exec() = 0;
 
 
+		/// \brief Free storage of the module for the actual run
+		///
+		/// Only available while exec() does run. The storage is destroyed
+		/// with the context of the run.
+		std::any& scratch()const{
+			return run_context().scratch(number);
+		}
+
+		/// \brief Memory that is released as a whole after the actual run
+		///
+		/// Only available while exec() does run. Use it for temporary data
+		/// that does not outlive the run, not for output data.
+		std::pmr::memory_resource& run_memory()const{
+			return run_context().memory();
+		}
+
+
+		/// \brief Stop the run after exec() returns
+		///
+		/// All modules of the run that are not yet executed get a cleanup()
+		/// call like after an exception, but the run ends without error
+		/// and chain::exec() returns false. Use it for intentionally
+		/// dropped runs, it is much cheaper than throwing.
+		///
+		/// Only available while exec() does run.
+		void abort_run()noexcept{ status_ = run_status::abort_run; }
+
+		/// \brief Skip all modules that depend on this module after exec()
+		///        returns
+		///
+		/// The skipped modules get a cleanup() call. Modules that do not
+		/// read data of this module, directly or indirectly, are executed
+		/// as usual.
+		///
+		/// Only available while exec() does run.
+		void skip_rest()noexcept{ status_ = run_status::skip_rest; }
+
+
 		/// \brief Enables the module for exec calls
 		///
 		/// By default the function does nothing.
@@ -196,9 +271,24 @@ namespace disposer{
 
 
 	private:
+		/// \brief The context of the run the module processes
+		///
+		/// Throws if exec() does not run.
+		exec_context& run_context()const{
+			if(context_ == nullptr){
+				throw std::logic_error("module '" + chain + "'.'" + name +
+					"': the run is only available while exec() does run");
+			}
+
+			return *context_;
+		}
+
+
 		/// Actual ID while exec() does run
-		std::size_t id_;
+		std::size_t id_ = 0;
 
+		/// \brief Context of the run while exec() does run
+		exec_context* context_ = nullptr;
 
 		/// \brief List of inputs
 		input_list inputs_;
@@ -206,13 +296,22 @@ namespace disposer{
 		/// \brief List of outputs
 		output_list outputs_;
 
+		/// \brief Result of the actual exec() call
+		run_status status_ = run_status::proceed;
+
 
 		/// \brief Helper for log message functions
 		template < typename Log >
 		auto module_log(Log& log)const{
 			using log_t = detail::log::extract_log_t< Log >;
 			return [&](log_t& os){
-				os << "id(" << id << "." << number << ") exec chain '"
+				os << "id(";
+				if(context_){
+					os << context_->id;
+				}else{
+					os << '-';
+				}
+				os << "." << number << ") exec chain '"
 					<< chain << "' module '" << name << "': ";
 				log(os);
 			};
@@ -10,6 +10,7 @@
 #define _disposer__module_ptr__hpp_INCLUDED_
 
 #include <memory>
+#include <vector>
 #include <functional>
 #include <unordered_map>
 
@@ -22,6 +23,9 @@ namespace disposer{
 	/// \brief unique_ptr to class module_base or derived classes
 	using module_ptr = std::unique_ptr< module_base >;
 
+	/// \brief All instances of a module in a chain
+	using module_replicas = std::vector< module_ptr >;
+
 
 	struct make_data;
 
@@ -13,12 +13,17 @@
 #include "input_base.hpp"
 #include "output_base.hpp"
 #include "output_data.hpp"
+#include "exec_context.hpp"
+#include "data_pool.hpp"
 #include "are_types_distinct.hpp"
 #include "type_position.hpp"
 
 #include <boost/hana.hpp>
 
 #include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 
 
 namespace disposer{
@@ -35,40 +40,127 @@ namespace disposer{
 		using value_type = T;
 
 
-		output_interface(signal_t& signal): signal_(signal) {}
+		output_interface(
+			signal_t& signal,
+			std::size_t type_position,
+			data_pool_ptr const& pool
+		):
+			signal_(signal), type_position_(type_position), pool_(pool) {}
 
 
-		void operator()(std::size_t id, value_type&& value){
-			exec_signal(
-				id,
-				std::make_shared< output_data< value_type > >(std::move(value))
-			);
+		void operator()(
+			std::size_t run, std::size_t id, value_type&& value
+		){
+			if constexpr(is_inline_data_v< value_type >){
+				exec_signal(run, id, value);
+			}else{
+				exec_signal(
+					run,
+					id,
+					make_pooled< output_data< value_type > >(
+						pool_, std::move(value))
+				);
+			}
 		}
 
-		void operator()(std::size_t id, value_type const& value){
-			exec_signal(
-				id,
-				std::make_shared< output_data< value_type > >(value)
-			);
+		void operator()(
+			std::size_t run, std::size_t id, value_type const& value
+		){
+			if constexpr(is_inline_data_v< value_type >){
+				exec_signal(run, id, value);
+			}else{
+				exec_signal(
+					run,
+					id,
+					make_pooled< output_data< value_type > >(pool_, value)
+				);
+			}
 		}
 
 		void operator()(
-			std::size_t id, output_data_ptr< value_type > const& value
+			std::size_t run,
+			std::size_t id,
+			output_data_ptr< value_type > const& value
 		){
-			exec_signal(id, value);
+			if constexpr(is_inline_data_v< value_type >){
+				exec_signal(run, id, value->data());
+			}else{
+				exec_signal(run, id, value);
+			}
+		}
+
+		/// \brief Type of a batch of values for range()
+		using batch_type = std::pmr::vector< signal_data_t< value_type > >;
+
+		/// \brief Build a batch of values in memory
+		///
+		/// values is traversed once, so it can be a single pass range.
+		template < typename Range >
+		batch_type batch(Range&& values, std::pmr::memory_resource& memory){
+			using iterator = decltype(std::begin(values));
+			using category =
+				typename std::iterator_traits< iterator >::iterator_category;
+
+			batch_type batch(&memory);
+			if constexpr(
+				std::is_base_of_v< std::forward_iterator_tag, category >
+			){
+				batch.reserve(static_cast< std::size_t >(
+					std::distance(std::begin(values), std::end(values))));
+			}
+
+			for(auto&& value: values){
+				if constexpr(is_inline_data_v< value_type >){
+					batch.push_back(value);
+				}else if constexpr(std::is_lvalue_reference_v< Range >){
+					batch.push_back(make_pooled< output_data< value_type > >(
+						pool_, value));
+				}else{
+					batch.push_back(make_pooled< output_data< value_type > >(
+						pool_, std::move(value)));
+				}
+			}
+
+			return batch;
+		}
+
+		/// \brief Put a batch with the ids first_id, first_id + 1, ...
+		///
+		/// Every target gets the batch with one call.
+		void range(
+			std::size_t run,
+			std::size_t first_id,
+			batch_type const& batch
+		){
+			if(batch.empty()) return;
+
+			signal_.put_range(
+				run,
+				first_id,
+				reinterpret_cast< any_type const* >(batch.data()),
+				batch.size(),
+				type_position_
+			);
 		}
 
 
 	private:
 		signal_t& signal_;
 
+		std::size_t const type_position_;
+
+		data_pool_ptr const& pool_;
+
 		void exec_signal(
-			std::size_t id, output_data_ptr< value_type > const& value
+			std::size_t run,
+			std::size_t id,
+			signal_data_t< value_type > const& value
 		){
 			signal_(
+				run,
 				id,
 				reinterpret_cast< any_type const& >(value),
-				type_id_with_cvr< T >()
+				type_position_
 			);
 		}
 	};
@@ -114,16 +206,56 @@ namespace disposer{
 					"type V in put< V > is not a output type"
 				);
 
-				if(!active_types_[type_position_v< V, T, U ... >]){
+				verify_active< V >();
+
+				constexpr auto position = type_position_v< V, T, U ... >;
+				auto const& context = run_context();
+				return output_interface< V >(
+					signal, position, pools_[position]
+				)(context.run, context.id, static_cast< W&& >(value)
+				);
+			}
+
+			/// \brief Put the values with the ids first_id, first_id + 1,
+			///        ...
+			///
+			/// All ids must be in the range that the module reserved with
+			/// its id_increase, otherwise std::logic_error is thrown. Every
+			/// connected input gets the whole range at once.
+			template < typename V, typename Range >
+			void put_range(std::size_t first_id, Range&& values){
+				static_assert(
+					hana::contains(value_types, hana::type_c< V >),
+					"type V in put_range< V > is not a output type"
+				);
+
+				verify_active< V >();
+
+				constexpr auto position = type_position_v< V, T, U ... >;
+				output_interface< V > output(
+					signal, position, pools_[position]);
+
+				// count while building the batch, values may be a single
+				// pass range
+				auto& context = run_context();
+				auto const batch = output.batch(
+					static_cast< Range&& >(values), context.memory());
+				auto const count = batch.size();
+				if(
+					first_id < context.id || count > id_increase_ ||
+					first_id - context.id > id_increase_ - count
+				){
 					throw std::logic_error(
-						"output '" + name + "' put inactive type [" +
-						type_name_with_cvr< V >() + "]"
+						"output '" + name + "' put the ids [" +
+						std::to_string(first_id) + ", " +
+						std::to_string(first_id + count) + ") outside of "
+						"the ids [" + std::to_string(context.id) + ", " +
+						std::to_string(context.id + id_increase_) +
+						") of the run"
 					);
 				}
 
-				return output_interface< V >(signal)(
-					id, static_cast< W&& >(value)
-				);
+				output.range(context.run, first_id, batch);
 			}
 
 
@@ -165,6 +297,21 @@ namespace disposer{
 
 
 		protected:
+			virtual void use_data_pools(
+				data_pools& pools,
+				std::pmr::memory_resource& resource
+			)override{
+				pools_ = {{
+					pools.get(type_id_with_cvr< T >(), resource),
+					pools.get(type_id_with_cvr< U >(), resource) ...
+				}};
+			}
+
+			virtual std::vector< type_index > types()const override{
+				return std::vector< type_index >(
+					type_indices_.begin(), type_indices_.end());
+			}
+
 			virtual std::vector< type_index > active_types()const override{
 				std::vector< type_index > result;
 				result.reserve(1 + sizeof...(U));
@@ -176,10 +323,25 @@ namespace disposer{
 
 
 		private:
+			/// \brief Throw if type V is not enabled
+			template < typename V >
+			void verify_active()const{
+				if(!active_types_[type_position_v< V, T, U ... >]){
+					throw std::logic_error(
+						"output '" + name + "' put inactive type [" +
+						type_name_with_cvr< V >() + "]"
+					);
+				}
+			}
+
+
 			static std::array< type_index, 1 + sizeof...(U) > const
 				type_indices_;
 
 			std::array< bool, 1 + sizeof...(U) > active_types_{{false}};
+
+			/// \brief Per output type the pool for the data
+			std::array< data_pool_ptr, 1 + sizeof...(U) > pools_;
 		};
 
 		template < typename T, typename ... U >
@@ -233,6 +395,13 @@ namespace disposer{
 				static_cast< W&& >(value)
 			);
 		}
+
+		template < typename Range >
+		void put_range(std::size_t first_id, Range&& values){
+			detail::output::output< T >::template put_range< T >(
+				first_id, static_cast< Range&& >(values)
+			);
+		}
 	};
 
 	template < typename T, typename ... U >
@@ -257,6 +426,13 @@ namespace disposer{
 			detail::output::container_output< Container, T ... >::
 				template put< Container< V > >(static_cast< W&& >(value));
 		}
+
+		template < typename V, typename Range >
+		void put_range(std::size_t first_id, Range&& values){
+			detail::output::container_output< Container, T ... >::
+				template put_range< Container< V > >(
+					first_id, static_cast< Range&& >(values));
+		}
 	};
 
 	template < template< typename, typename ... > class Container, typename T >
@@ -270,6 +446,13 @@ namespace disposer{
 			detail::output::container_output< Container, T >::
 				template put< Container< T > >(static_cast< W&& >(value));
 		}
+
+		template < typename Range >
+		void put_range(std::size_t first_id, Range&& values){
+			detail::output::container_output< Container, T >::
+				template put_range< Container< T > >(
+					first_id, static_cast< Range&& >(values));
+		}
 	};
 
 	template <
@@ -11,35 +11,152 @@
 
 #include "input_base.hpp"
 
+#include "memory_resources.hpp"
+
 #include <utility>
+#include <functional>
 
 
 namespace disposer{
 
 
 	/// \brief Connection between an output and an input
+	///
+	/// connect() compiles the targets into one contiguous list of
+	/// deliveries per output type. A delivery holds the entry point of the
+	/// input for this type and last_use, so passing data to a target is
+	/// one indirect call.
 	class signal_t{
 	public:
 		/// \brief Called by output to move data to receiving inputs
+		///
+		/// type_position is the position of the data type in the output
+		/// type list. If the target module has replicas, only the replica
+		/// that processes run gets the data.
 		void operator()(
-			std::size_t id, any_type const& data, type_index const& type
+			std::size_t run,
+			std::size_t id,
+			any_type const& data,
+			std::size_t type_position
 		)const{
-			for(auto& [input, last_use]: targets_){
-				input.add(signal_t_key(), id, data, type, last_use);
+			if(type_position >= deliveries_.size()) return;
+
+			for(auto& delivery: deliveries_[type_position]){
+				delivery.add(input(delivery, run), run, id, data);
 			}
 		}
 
+		/// \brief Called by output to move the data of count successive
+		///        ids to receiving inputs
+		///
+		/// data points to the first of count signal_data_t's. Every input
+		/// gets the whole batch with one call.
+		void put_range(
+			std::size_t run,
+			std::size_t first_id,
+			any_type const* data,
+			std::size_t count,
+			std::size_t type_position
+		)const{
+			if(type_position >= deliveries_.size()) return;
+
+			for(auto& delivery: deliveries_[type_position]){
+				delivery.add_range(
+					input(delivery, run), run, first_id, data, count);
+			}
+		}
+
+		/// \brief true if at least one input is connected
+		bool is_connected()const noexcept{
+			return !inputs_.empty();
+		}
+
+		/// \brief true if at least one connected input is demanded in the
+		///        run of context
+		bool is_demanded(exec_context const& context)const{
+			if(deliveries_.empty()) return false;
+
+			for(auto& delivery: deliveries_.front()){
+				if(input(delivery, context.run).is_demanded(context)){
+					return true;
+				}
+			}
+			return false;
+		}
+
 		/// \brief Add an input to the target list
 		///
+		/// types is the output type list. inputs contains the input of
+		/// every replica of the target module.
+		///
 		/// The last_use flag shall be true, if the input is the last which
 		/// gets the variable in the chain.
-		void connect(input_base& input, bool last_use){
-			targets_.emplace_back(input, last_use);
+		void connect(
+			std::vector< type_index > const& types,
+			std::vector< std::reference_wrapper< input_base > >&& inputs,
+			bool last_use
+		){
+			if(deliveries_.empty()) deliveries_.resize(types.size());
+
+			auto const first_input = inputs_.size();
+			for(auto& input: inputs) inputs_.push_back(&input.get());
+
+			// resolve the entry points of the input once
+			auto& input = inputs.front().get();
+			for(std::size_t i = 0; i < types.size(); ++i){
+				auto const entry = input.get_entry_points(
+					signal_t_key(), types[i], last_use);
+
+				deliveries_[i].push_back({
+					entry.add,
+					entry.add_range,
+					&input,
+					inputs.size(),
+					first_input
+				});
+			}
+		}
+
+		/// \brief Use resource for the delivery lists
+		///
+		/// Must be called before the first connect().
+		void set_memory_resource(std::pmr::memory_resource& resource){
+			use_memory_resource(deliveries_, resource);
+			use_memory_resource(inputs_, resource);
 		}
 
 	private:
-		/// \brief List of all connected inputs
-		std::vector< std::pair< input_base&, bool > > targets_;
+		/// \brief Data path from the output to one connected input
+		struct delivery{
+			/// \brief Entry point of the input for the type
+			input_base::add_function add;
+
+			/// \brief Batch entry point of the input for the type
+			input_base::add_range_function add_range;
+
+			/// \brief The input if the target module has no replicas
+			input_base* input;
+
+			/// \brief Count of replicas of the target module
+			std::size_t replicas;
+
+			/// \brief Index of the input of the first replica in inputs_
+			std::size_t first_input;
+		};
+
+		/// \brief The input of delivery that gets the data of run
+		input_base& input(delivery const& delivery, std::size_t run)
+		const noexcept{
+			if(delivery.replicas == 1) return *delivery.input;
+			return *inputs_[delivery.first_input + run % delivery.replicas];
+		}
+
+
+		/// \brief Per output type position the deliveries to all targets
+		std::pmr::vector< std::pmr::vector< delivery > > deliveries_;
+
+		/// \brief The inputs of all replicas of all targets
+		std::pmr::vector< input_base* > inputs_;
 	};
 
 
@@ -52,7 +169,7 @@ namespace disposer{
 	class output_base{
 	public:
 		/// \brief Constructor
-		output_base(std::string const& name): name(name), id(id_), id_(0) {}
+		output_base(std::string const& name): name(name) {}
 
 		/// \brief Outputs are not copyable
 		output_base(output_base const&) = delete;
@@ -68,33 +185,87 @@ namespace disposer{
 		output_base& operator=(output_base&&) = delete;
 
 
+		/// \brief List of all output types in the order of their position
+		virtual std::vector< type_index > types()const = 0;
+
 		/// \brief List of active output types
 		virtual std::vector< type_index > active_types()const = 0;
 
 
-		/// \brief Set the new id for the next exec or cleanup
-		void set_id(module_base_key, std::size_t id)noexcept{ id_ = id; }
+		/// \brief true if at least one input is connected to the output
+		bool is_connected()const noexcept{
+			return signal.is_connected();
+		}
+
+		/// \brief true if at least one connected input needs the data of
+		///        the current run
+		///
+		/// Modules can skip the calculation of data nobody needs.
+		bool is_demanded()const{
+			return signal.is_demanded(run_context());
+		}
 
 
 		/// \brief Access the internal signal object
 		signal_t& get_signal(creator_key){ return signal; }
 
+		/// \brief Call use_data_pools(pools, resource)
+		///
+		/// The signal uses resource for its target list.
+		void set_data_pools(
+			creator_key,
+			data_pools& pools,
+			std::pmr::memory_resource& resource
+		){
+			signal.set_memory_resource(resource);
+			use_data_pools(pools, resource);
+		}
+
+
+		/// \brief Set the id_increase of the module that owns the output
+		void set_id_increase(creator_key, std::size_t id_increase)noexcept{
+			id_increase_ = id_increase;
+		}
+
+		/// \brief Set the context of the run the owning module processes
+		///
+		/// context is a member of the module, it is set while the module
+		/// processes a run.
+		void set_module_context(
+			creator_key,
+			exec_context* const& context
+		)noexcept{
+			module_context_ = &context;
+		}
+
 
 		/// \brief Name of the output in the config file
 		std::string const name;
 
 
 	protected:
-		signal_t signal;
+		/// \brief Count of ids the module may put per run
+		std::size_t id_increase_ = 1;
+
+		/// \brief The context of the run the owning module processes
+		exec_context* const* module_context_ = nullptr;
 
-		/// \brief Read only reference to the actual ID while module::exec()
-		///        is running
-		std::size_t const& id;
+		/// \brief The context of the run the owning module processes
+		///
+		/// Without module it is the current context of the calling thread.
+		/// Throws if there is none.
+		exec_context& run_context()const{
+			if(module_context_ && *module_context_) return **module_context_;
+			return exec_context::get();
+		}
 
+		/// \brief Get the pools for the data of the output types
+		virtual void use_data_pools(
+			data_pools& pools,
+			std::pmr::memory_resource& resource
+		) = 0;
 
-	private:
-		/// \brief The actual ID while module::exec() is running
-		std::size_t id_;
+		signal_t signal;
 	};
 
 
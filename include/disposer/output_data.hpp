@@ -9,6 +9,7 @@
 #ifndef _disposer__output_data__hpp_INCLUDED_
 #define _disposer__output_data__hpp_INCLUDED_
 
+#include <type_traits>
 #include <memory>
 #include <future>
 #include <mutex>
@@ -25,6 +26,72 @@ namespace disposer{
 	using output_data_ptr = std::shared_ptr< output_data< T > >;
 
 
+	/// \brief Maximal size of data that is passed by value
+	constexpr std::size_t inline_data_size = 2 * sizeof(void*);
+
+	/// \brief true if data of type T is passed by value from outputs to
+	///        inputs
+	///
+	/// Small trivially copyable data is copied into every input, this is
+	/// cheaper than a heap allocation and the atomic reference counting of
+	/// output_data_ptr.
+	template < typename T >
+	constexpr bool is_inline_data_v =
+		std::is_trivially_copyable_v< T > && sizeof(T) <= inline_data_size;
+
+	/// \brief Type of data of type T while it is passed from outputs to
+	///        inputs
+	template < typename T >
+	using signal_data_t = std::conditional_t<
+		is_inline_data_v< T >, T, output_data_ptr< T > >;
+
+
+	/// \brief Pointer like holder of an own copy of small data
+	///
+	/// input_data< T >::get() returns it for data that is passed by value,
+	/// so the copy for write access needs no heap allocation. It converts
+	/// to an output_data_ptr, which allocates.
+	template < typename T >
+	class inline_data_ptr{
+	public:
+		/// \brief Constructor
+		explicit inline_data_ptr(T const& data): data_(data) {}
+
+
+		/// \brief Access the data
+		output_data< T >* operator->()noexcept{ return &data_; }
+
+		/// \brief Access the data
+		output_data< T > const* operator->()const noexcept{ return &data_; }
+
+		/// \brief Access the data
+		output_data< T >& operator*()noexcept{ return data_; }
+
+		/// \brief Access the data
+		output_data< T > const& operator*()const noexcept{ return data_; }
+
+		/// \brief Always true, like a not empty output_data_ptr
+		explicit operator bool()const noexcept{ return true; }
+
+
+		/// \brief Copy the data into a new output_data_ptr
+		operator output_data_ptr< T >()const{
+			return std::make_shared< output_data< T > >(data_.data());
+		}
+
+
+	private:
+		/// \brief The data
+		output_data< T > data_;
+	};
+
+
+	/// \brief Type that input_data< T >::get() returns
+	template < typename T >
+	using exclusive_data_ptr_t = std::conditional_t<
+		is_inline_data_v< T >, inline_data_ptr< T >, output_data_ptr< T > >;
+
+
 	/// \brief Wrapper for output data
 	template < typename T >
 	class output_data{
@@ -52,6 +52,7 @@ namespace disposer{
 			std::string name;
 			std::vector< io > inputs;
 			std::vector< io > outputs;
+			std::vector< parameter > parameters;
 		};
 
 		struct chain{
@@ -59,6 +60,10 @@ namespace disposer{
 			std::optional< std::string > group;
 			std::optional< std::string > id_generator;
 			std::vector< chain_module > modules;
+			std::optional< std::string > memory_resource;
+			std::optional< std::string > max_in_flight;
+			std::optional< std::string > overload_policy;
+			std::optional< std::string > run_order;
 		};
 
 		using chains = std::vector< chain >;
@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__sequence_barrier__hpp_INCLUDED_
+#define _disposer__sequence_barrier__hpp_INCLUDED_
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+
+namespace disposer{
+
+
+	/// \brief Lets the runs of a chain pass a module strictly in run order
+	///
+	/// The barrier holds a cursor with the next run that is allowed to pass.
+	/// If the cursor already has the expected value, wait() only does an
+	/// atomic load. Otherwise the calling thread registers itself with its
+	/// run number and sleeps on its own condition variable. release() wakes
+	/// only the thread that waits for the next run, all other waiting
+	/// threads keep sleeping.
+	///
+	/// Instead of a sleeping thread a run can also register a continuation
+	/// via async_wait(), which release() calls when the run can pass.
+	///
+	/// A barrier can have more than one lane, run r uses lane r % lanes.
+	/// Every lane has its own cursor, so the runs of different lanes pass
+	/// independently of each other.
+	class sequence_barrier{
+	public:
+		/// \brief The first run that can pass lane i is i
+		explicit sequence_barrier(std::size_t lanes = 1);
+
+		/// \brief Destroy continuations of runs that never passed
+		~sequence_barrier();
+
+
+		/// \brief Barriers are not copyable
+		sequence_barrier(sequence_barrier const&) = delete;
+
+		/// \brief Barriers are not movable
+		sequence_barrier(sequence_barrier&&) = delete;
+
+
+		/// \brief Barriers are not copyable
+		sequence_barrier& operator=(sequence_barrier const&) = delete;
+
+		/// \brief Barriers are not movable
+		sequence_barrier& operator=(sequence_barrier&&) = delete;
+
+
+		/// \brief Count of lanes
+		std::size_t lanes()const noexcept{ return lanes_; }
+
+		/// \brief The run that is allowed to pass next in the lane of run
+		std::size_t ready_run(std::size_t run = 0)const noexcept{
+			return cursor(run).load(std::memory_order_acquire);
+		}
+
+		/// \brief Block until run is allowed to pass
+		void wait(std::size_t run);
+
+		/// \brief Call continuation as soon as run is allowed to pass
+		///
+		/// Returns true without calling continuation if run can pass
+		/// immediately. Otherwise continuation is called by the release()
+		/// call that lets run pass and false is returned.
+		bool async_wait(
+			std::size_t run,
+			std::function< void() >&& continuation
+		);
+
+		/// \brief Let the next run of the lane pass, run must be the actual
+		///        ready_run(run)
+		void release(std::size_t run);
+
+
+		/// \brief Count of wakeups of sleeping threads
+		///
+		/// In an undisturbed system this is the count of wait() calls that
+		/// had to sleep.
+		std::size_t wakeups()const noexcept{
+			return wakeups_.load(std::memory_order_relaxed);
+		}
+
+
+	private:
+		/// \brief A sleeping thread or a continuation
+		struct waiter;
+
+		/// \brief Add waiter to the list, mutex_ must be locked
+		void push(waiter& w)noexcept;
+
+		/// \brief Remove waiter from the list, mutex_ must be locked
+		void erase(waiter& w)noexcept;
+
+		/// \brief The cursor of the lane of run
+		std::atomic< std::size_t >& cursor(std::size_t run)const noexcept{
+			return ready_run_[run % lanes_];
+		}
+
+
+		/// \brief Count of lanes
+		std::size_t const lanes_;
+
+		/// \brief Per lane the next run that is allowed to pass
+		std::unique_ptr< std::atomic< std::size_t >[] > const ready_run_;
+
+		/// \brief Count of registered waiters
+		///
+		/// release() only locks the mutex if there is a waiter.
+		std::atomic< std::size_t > waiting_;
+
+		/// \brief Protects the waiters_ list
+		std::mutex mutex_;
+
+		/// \brief Intrusive list of the sleeping threads and continuations
+		waiter* waiters_;
+
+		/// \brief Count of wakeups of sleeping threads
+		std::atomic< std::size_t > wakeups_;
+	};
+
+
+}
+
+
+#endif
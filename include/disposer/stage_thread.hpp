@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__stage_thread__hpp_INCLUDED_
+#define _disposer__stage_thread__hpp_INCLUDED_
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+
+namespace disposer{
+
+
+	/// \brief A dedicated thread that executes the module steps of one
+	///        pipeline stage
+	///
+	/// The thread is the only consumer of its queue. It takes all waiting
+	/// tasks with one lock and executes them without holding it, so the
+	/// producers only contend for a push. The thread can be pinned to a
+	/// set of CPUs, which keeps the working set of the modules of the
+	/// stage in the caches of these cores.
+	class stage_thread{
+	public:
+		/// \brief Start the thread
+		///
+		/// If cpus is not empty, the thread is pinned to these CPUs. Throws
+		/// if the CPU affinity can not be set. On systems without CPU
+		/// affinity support cpus is ignored.
+		stage_thread(std::string name, std::vector< std::size_t > cpus);
+
+		/// \brief Execute all posted tasks and join the thread
+		~stage_thread();
+
+
+		/// \brief Stage threads are not copyable
+		stage_thread(stage_thread const&) = delete;
+
+		/// \brief Stage threads are not movable
+		stage_thread(stage_thread&&) = delete;
+
+
+		/// \brief Stage threads are not copyable
+		stage_thread& operator=(stage_thread const&) = delete;
+
+		/// \brief Stage threads are not movable
+		stage_thread& operator=(stage_thread&&) = delete;
+
+
+		/// \brief Execute task in the thread
+		///
+		/// The task must not throw.
+		void post(std::function< void() >&& task);
+
+		/// \brief The stage thread of the calling thread, nullptr if it is
+		///        no stage thread
+		static stage_thread const* current()noexcept;
+
+
+		/// \brief The CPUs the thread is pinned to, empty if not pinned
+		std::vector< std::size_t > const& cpus()const noexcept{
+			return cpus_;
+		}
+
+		/// \brief Count of started tasks
+		std::size_t tasks()const noexcept{
+			return tasks_.load(std::memory_order_relaxed);
+		}
+
+		/// \brief Time the thread spent in finished tasks
+		std::chrono::nanoseconds busy_time()const noexcept{
+			return std::chrono::nanoseconds(
+				busy_time_.load(std::memory_order_relaxed));
+		}
+
+
+		/// \brief Name of the stage
+		std::string const name;
+
+
+	private:
+		/// \brief Function of the thread
+		void work()noexcept;
+
+		/// \brief Pin the thread to cpus_
+		void pin();
+
+		/// \brief Let the thread finish all tasks and join it
+		void stop()noexcept;
+
+
+		/// \brief The CPUs the thread is pinned to
+		std::vector< std::size_t > const cpus_;
+
+		/// \brief Protects task_queue_ and shutdown_
+		std::mutex mutex_;
+
+		/// \brief Wakes the thread
+		std::condition_variable cv_;
+
+		/// \brief The waiting tasks
+		std::deque< std::function< void() > > task_queue_;
+
+		/// \brief Set by the destructor
+		bool shutdown_;
+
+		/// \brief Count of started tasks
+		std::atomic< std::size_t > tasks_;
+
+		/// \brief Nanoseconds the thread spent in tasks
+		std::atomic< std::int64_t > busy_time_;
+
+		/// \brief The thread
+		std::thread thread_;
+	};
+
+
+}
+
+
+#endif
@@ -0,0 +1,152 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#ifndef _disposer__thread_pool__hpp_INCLUDED_
+#define _disposer__thread_pool__hpp_INCLUDED_
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+
+namespace disposer{
+
+
+	/// \brief Work-stealing scheduler for the module steps of all chains
+	///
+	/// Every worker thread owns a deque. Tasks posted by a worker go to the
+	/// back of its own deque and are taken from there in LIFO order, which
+	/// keeps the data of a run in the cache of one core. Tasks posted by
+	/// other threads go to a shared injection queue. A worker without work
+	/// takes the front of the injection queue or steals from the front of
+	/// the deque of another worker. Workers without any work sleep.
+	class thread_pool{
+	public:
+		/// \brief Start thread_count worker threads
+		///
+		/// If thread_count is 0, one thread per hardware thread is started.
+		explicit thread_pool(std::size_t thread_count = 0);
+
+		/// \brief Execute all posted tasks and join the worker threads
+		~thread_pool();
+
+
+		/// \brief Thread pools are not copyable
+		thread_pool(thread_pool const&) = delete;
+
+		/// \brief Thread pools are not movable
+		thread_pool(thread_pool&&) = delete;
+
+
+		/// \brief Thread pools are not copyable
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		/// \brief Thread pools are not movable
+		thread_pool& operator=(thread_pool&&) = delete;
+
+
+		/// \brief Execute task in one of the worker threads
+		///
+		/// The task must not throw.
+		void post(std::function< void() >&& task);
+
+		/// \brief Execute one waiting task in the calling thread
+		///
+		/// Returns false if there was no task.
+		bool run_one();
+
+		/// \brief Execute tasks in the calling thread until done() is true
+		///
+		/// The thread sleeps like an idle worker while there is no task.
+		/// Whoever makes done() true must call wake_helpers() afterwards.
+		/// done() is not called again after it returned true, so it may
+		/// take a resource on success. It is called with a lock held, so
+		/// it must not post tasks.
+		///
+		/// A task that calls run_until() again nests on the stack of the
+		/// calling thread. The nesting is not limited, callers must make
+		/// sure that tasks do not wait recursively without bound.
+		void run_until(std::function< bool() > const& done);
+
+		/// \brief Wake the threads in run_until() to check their condition
+		void wake_helpers();
+
+		/// \brief true if the calling thread is a worker of this pool
+		bool is_worker()const noexcept;
+
+
+		/// \brief Count of worker threads
+		std::size_t thread_count()const noexcept{ return workers_.size(); }
+
+
+	private:
+		/// \brief Task deque of a worker
+		struct task_queue{
+			/// \brief Protects tasks
+			std::mutex mutex;
+
+			/// \brief The waiting tasks
+			std::deque< std::function< void() > > tasks;
+		};
+
+		/// \brief Function of the worker threads
+		void work(std::size_t index)noexcept;
+
+		/// \brief Get a task from the own deque, the injection queue or
+		///        another worker
+		///
+		/// index is the own worker index or thread_count() for threads that
+		/// are not a worker.
+		bool pop(std::size_t index, std::function< void() >& task);
+
+
+		/// \brief One deque per worker
+		std::vector< std::unique_ptr< task_queue > > workers_;
+
+		/// \brief Tasks posted by threads that are not a worker
+		task_queue injected_;
+
+		/// \brief Count of waiting tasks in all queues
+		///
+		/// post() increments it before it pushes the task, so it is never
+		/// less than the count of tasks in the queues.
+		std::atomic< std::size_t > pending_;
+
+		/// \brief Count of sleeping workers
+		///
+		/// post() only locks sleep_mutex_ if a worker sleeps.
+		std::atomic< std::size_t > sleeping_;
+
+		/// \brief Count of threads that sleep in run_until()
+		///
+		/// wake_helpers() only locks sleep_mutex_ if a thread sleeps.
+		std::atomic< std::size_t > helping_;
+
+		/// \brief Protects shutdown_ and the sleep of the workers
+		std::mutex sleep_mutex_;
+
+		/// \brief Wakes the sleeping workers
+		std::condition_variable sleep_cv_;
+
+		/// \brief Set by the destructor
+		bool shutdown_;
+
+		/// \brief The worker threads
+		std::vector< std::thread > threads_;
+	};
+
+
+}
+
+
+#endif
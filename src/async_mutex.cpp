@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/async_mutex.hpp>
+
+
+namespace disposer{
+
+
+	bool async_mutex::async_lock(std::function< void() >&& continuation){
+		std::lock_guard< std::mutex > lock(mutex_);
+		if(!locked_){
+			locked_ = true;
+			return true;
+		}
+
+		continuations_.push_back(std::move(continuation));
+		return false;
+	}
+
+	void async_mutex::unlock(){
+		std::function< void() > continuation;
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			if(continuations_.empty()){
+				locked_ = false;
+				return;
+			}
+
+			// the lock stays locked for the continuation
+			continuation = std::move(continuations_.front());
+			continuations_.pop_front();
+		}
+
+		continuation();
+	}
+
+
+}
@@ -10,36 +10,210 @@
 #include <disposer/module_base.hpp>
 #include <disposer/create_chain_modules.hpp>
 
-#include <numeric>
+#include <algorithm>
 
 
 namespace disposer{
 
 
+	namespace{
+
+
+		/// \brief The config line 'max_in_flight = count', 0 without line
+		std::size_t config_max_in_flight(
+			types::merge::chain const& config_chain
+		){
+			auto const& value = config_chain.max_in_flight;
+			if(value.empty()) return 0;
+
+			bool const is_number = std::all_of(
+				value.begin(), value.end(),
+				[](char c){ return c >= '0' && c <= '9'; });
+
+			std::size_t count = 0;
+			if(is_number){
+				try{
+					count = std::stoul(value);
+				}catch(std::out_of_range const&){}
+			}
+
+			if(count == 0){
+				throw std::logic_error(
+					"In chain '" + config_chain.name + "': 'max_in_flight' "
+					"must be a positive number, but is '" + value + "'"
+				);
+			}
+
+			return count;
+		}
+
+		/// \brief The config line 'overload_policy = policy'
+		overload_policy config_overload_policy(
+			types::merge::chain const& config_chain
+		){
+			auto const& value = config_chain.overload_policy;
+			if(value.empty() || value == "block") return overload_policy::block;
+			if(value == "fail") return overload_policy::fail;
+			if(value == "drop_oldest") return overload_policy::drop_oldest;
+
+			throw std::logic_error(
+				"In chain '" + config_chain.name + "': 'overload_policy' "
+				"must be 'block', 'fail' or 'drop_oldest', but is '" + value +
+				"'"
+			);
+		}
+
+		/// \brief true with the config line 'run_order = relaxed'
+		bool config_relaxed_order(types::merge::chain const& config_chain){
+			auto const& value = config_chain.run_order;
+			if(value.empty() || value == "strict") return false;
+			if(value == "relaxed") return true;
+
+			throw std::logic_error(
+				"In chain '" + config_chain.name + "': 'run_order' must be "
+				"'strict' or 'relaxed', but is '" + value + "'"
+			);
+		}
+
+
+		/// \brief The chain module parameter 'cpus = 0,2-3'
+		std::vector< std::size_t > config_cpus(
+			types::merge::chain const& config_chain,
+			types::merge::chain_module const& config_module
+		){
+			auto iter = config_module.parameters.find("cpus");
+			if(iter == config_module.parameters.end()) return {};
+
+			auto const& value = iter->second;
+			auto const error = [&]{
+				return std::logic_error(
+					"In chain '" + config_chain.name + "' module '" +
+					config_module.module.first + "': Parameter 'cpus' must "
+					"be a list of CPU numbers like '0,2-3', but is '" +
+					value + "'"
+				);
+			};
+
+			auto const number = [&](auto& pos){
+				auto const first = pos;
+				while(pos != value.end() && *pos >= '0' && *pos <= '9') ++pos;
+				if(first == pos || pos - first > 4) throw error();
+				return std::stoul(std::string(first, pos));
+			};
+
+			std::vector< std::size_t > cpus;
+			auto pos = value.begin();
+			for(;;){
+				auto const first = number(pos);
+				auto last = first;
+				if(pos != value.end() && *pos == '-') last = number(++pos);
+				if(last < first) throw error();
+
+				for(auto cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+
+				if(pos == value.end()) break;
+				if(*pos++ != ',') throw error();
+			}
+
+			std::sort(cpus.begin(), cpus.end());
+			cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+			return cpus;
+		}
+
+		/// \brief The chain module parameter 'stage = name', the module
+		///        name if only 'cpus' is set, empty without both
+		std::string config_stage(
+			types::merge::chain_module const& config_module
+		){
+			auto const& parameters = config_module.parameters;
+			auto iter = parameters.find("stage");
+			if(iter != parameters.end()) return iter->second;
+			if(parameters.count("cpus") > 0) return config_module.module.first;
+			return {};
+		}
+
+
+	}
+
+
 	chain::chain(
 		module_maker_list const& maker_list,
 		types::merge::chain const& config_chain,
 		id_generator& generate_id,
-		std::string const& group
+		std::string const& group,
+		thread_pool& pool,
+		memory_resources const& resources
 	):
 		name(config_chain.name),
 		group(group),
-		modules_(create_chain_modules(maker_list, config_chain)),
-		id_increase_(std::accumulate(
-			modules_.cbegin(),
-			modules_.cend(),
-			std::size_t(1),
-			[](std::size_t increase, module_ptr const& module){
-				return increase * module->id_increase;
-			}
-		)),
+		memory_(resources.get(config_chain.memory_resource)),
+		modules_(create_chain_modules(
+			maker_list, config_chain, pools_, resources)),
+		relaxed_order_(config_relaxed_order(config_chain)),
+		plan_(config_chain, modules_, memory_, relaxed_order_),
 		generate_id_(generate_id),
+		pool_(pool),
 		next_run_(0),
-		ready_run_(modules_.size()),
-		module_mutexes_(modules_.size()),
-		enabled_(false),
-		exec_calls_count_(0)
-		{}
+		demand_driven_(false),
+		max_in_flight_(config_max_in_flight(config_chain)),
+		overload_policy_(config_overload_policy(config_chain)),
+		in_flight_(0),
+		place_waiters_(0),
+		rejected_runs_(0),
+		dropped_runs_(0),
+		latest_wins_(false),
+		coalesced_runs_(0)
+	{
+		for(auto& replicas: modules_) ready_run_.emplace_back(replicas.size());
+
+		// with a limit, the inputs hold the data of all runs in progress
+		// without lock
+		if(auto const max = max_in_flight_.load(); max > 0){
+			set_slot_count(max);
+		}
+
+		// start one thread per stage
+		for(auto const& config_module: config_chain.modules){
+			auto const stage = config_stage(config_module);
+			if(stage.empty()){
+				module_stages_.push_back(nullptr);
+				continue;
+			}
+
+			auto cpus = config_cpus(config_chain, config_module);
+			auto iter = std::find_if(stages_.begin(), stages_.end(),
+				[&stage](auto const& thread){ return thread->name == stage; });
+			if(iter == stages_.end()){
+				stages_.push_back(
+					std::make_unique< stage_thread >(stage, std::move(cpus)));
+				module_stages_.push_back(stages_.back().get());
+				continue;
+			}
+
+			if((*iter)->cpus() != cpus){
+				throw std::logic_error(
+					"In chain '" + config_chain.name + "' module '" +
+					config_module.module.first + "': Parameter 'cpus' "
+					"differs from the other modules of stage '" + stage +
+					"'"
+				);
+			}
+
+			module_stages_.push_back(iter->get());
+		}
+
+		if(!relaxed_order_) return;
+
+		// a run may overtake older runs, so it must not take their data
+		for(auto& replicas: modules_){
+			for(auto& module: replicas){
+				exclusive_.emplace_back();
+				for(auto& input: module->inputs(make_creator_key())){
+					input.get().set_exact_run(make_creator_key(), true);
+				}
+			}
+		}
+	}
 
 
 	chain::~chain(){
@@ -47,108 +221,555 @@ namespace disposer{
 	}
 
 
-	namespace{
+	class chain::run_state{
+	public:
+		run_state(chain& c, exec_gate::pass&& pass, std::size_t run):
+			pass(std::move(pass)),
+			context(
+				c.generate_id_(c.plan_.id_increase()),
+				run,
+				c.plan_.size()
+			),
+			pending(c.plan_.size(), &context.memory()),
+			remaining(c.plan_.size()),
+			failed(false),
+			phase(phase_pending),
+			done(false)
+		{
+			for(std::size_t i = 0; i < c.plan_.size(); ++i){
+				pending[i].store(
+					c.plan_[i].dependency_count, std::memory_order_relaxed);
+			}
 
+			if(c.is_demand_driven()) c.mark_demanded(context);
+		}
 
-		class exec_call_manager{
-		public:
-			exec_call_manager(
-				std::atomic< std::size_t >& exec_calls_count,
-				std::condition_variable& enable_cv
-			):
-				exec_calls_count_(exec_calls_count),
-				enable_cv_(enable_cv){
-					++exec_calls_count_;
-				}
+		/// \brief Save the exception of a module
+		///
+		/// Only the first exception is saved.
+		void set_exception(std::exception_ptr&& error){
+			std::lock_guard< std::mutex > lock(mutex);
+			if(exception) return;
+			exception = std::move(error);
+			failed.store(true, std::memory_order_release);
+		}
+
+		/// \brief Mark the run as started
+		///
+		/// Returns false if the run did fail or was dropped.
+		bool start()noexcept{
+			auto expected = phase_pending;
+			phase.compare_exchange_strong(expected, phase_started);
+			return expected != phase_dropped
+				&& !failed.load(std::memory_order_acquire);
+		}
 
-			~exec_call_manager(){
-				--exec_calls_count_;
-				enable_cv_.notify_all();
+		/// \brief Drop the run if it did not start yet
+		///
+		/// All modules get a cleanup() call instead of exec().
+		bool drop()noexcept{
+			auto expected = phase_pending;
+			if(!phase.compare_exchange_strong(expected, phase_dropped)){
+				return false;
 			}
+			failed.store(true, std::memory_order_release);
+			return true;
+		}
 
-		private:
-			std::atomic< std::size_t >& exec_calls_count_;
-			std::condition_variable& enable_cv_;
-		};
+		/// \brief true if no module was executed yet
+		bool start_pending()const noexcept{
+			return phase.load(std::memory_order_acquire) == phase_pending;
+		}
 
+		/// \brief true if the run was dropped
+		bool is_dropped()const noexcept{
+			return phase.load(std::memory_order_acquire) == phase_dropped;
+		}
 
 
-	}
+		/// \brief No module was executed yet
+		static constexpr int phase_pending = 0;
+
+		/// \brief At least one module was executed
+		static constexpr int phase_started = 1;
+
+		/// \brief Dropped by overload_policy::drop_oldest
+		static constexpr int phase_dropped = 2;
+
+
+		/// \brief Keeps the chain enabled until the run is done
+		exec_gate::pass const pass;
+
+		/// \brief The id and the unique continuous index of the run
+		exec_context context;
+
+		/// \brief Per module the count of modules it still waits for
+		std::pmr::vector< std::atomic< std::size_t > > pending;
+
+		/// \brief Count of modules that are not done yet
+		std::atomic< std::size_t > remaining;
+
+		/// \brief true after a module did throw or abort the run
+		std::atomic< bool > failed;
+
+		/// \brief phase_pending, phase_started or phase_dropped
+		std::atomic< int > phase;
+
+		/// \brief Set after the promise got the result
+		std::atomic< bool > done;
+
+		/// \brief Protects exception
+		std::mutex mutex;
 
+		/// \brief The first exception thrown by a module
+		std::exception_ptr exception;
 
-	void chain::exec(){
-		if(!enabled_){
+		/// \brief Gets the result of the run
+		std::promise< bool > promise;
+	};
+
+
+	std::shared_ptr< chain::run_state > chain::new_run(){
+		exec_gate::pass pass(gate_);
+		if(!pass){
 			throw std::logic_error("chain '" + name + "' is not enabled");
 		}
 
-		exec_call_manager lock(exec_calls_count_, enable_cv_);
+		if(!admit()) return nullptr;
+
+		// the number is used up even if the run can not be created, the
+		// allocations and the demand predicates of the inputs can throw
+		auto const run = next_run_++;
+
+		try{
+			auto state = std::allocate_shared< run_state >(
+				std::pmr::polymorphic_allocator< run_state >(&memory_),
+				*this, std::move(pass), run);
+
+			bool const latest_wins = is_latest_wins();
+			if(latest_wins || overload_policy_.load(std::memory_order_relaxed)
+				== overload_policy::drop_oldest
+			){
+				std::size_t coalesced = 0;
+				{
+					std::lock_guard< std::mutex > lock(pending_mutex_);
+
+					if(latest_wins){
+						// the new run replaces all runs that did not start
+						for(auto& weak: pending_runs_){
+							auto pending = weak.lock();
+							if(pending && pending->drop()) ++coalesced;
+						}
+						pending_runs_.clear();
+					}else{
+						// forget the runs that started or are done
+						while(!pending_runs_.empty()){
+							auto front = pending_runs_.front().lock();
+							if(front && front->start_pending()) break;
+							pending_runs_.pop_front();
+						}
+					}
+
+					pending_runs_.push_back(state);
+				}
+
+				// free_place() locks place_mutex_, which admit() holds
+				// while it locks pending_mutex_
+				coalesced_runs_ += coalesced;
+				for(std::size_t i = 0; i < coalesced; ++i) free_place();
+			}
+
+			return state;
+		}catch(...){
+			pass_run(run);
+			free_place();
+			throw;
+		}
+	}
+
+
+	void chain::pass_run(std::size_t run){
+		for(std::size_t i = 0; i < plan_.size(); ++i){
+			if(!plan_[i].ordered) continue;
+
+			auto& barrier = ready_run_[i];
+			auto const release = [&barrier, run]{ barrier.release(run); };
+			if(barrier.async_wait(run, release)) release();
+		}
+	}
+
+
+	bool chain::exec(){
+		verify_no_stage_thread("exec()");
 
-		// generate a new id for the exec
-		std::size_t const id = generate_id_(id_increase_);
+		auto state = new_run();
+		if(!state) return false;
 
-		// generate a unique continuous index for the call
-		std::size_t const run = next_run_++;
+		auto future = state->promise.get_future();
 
-		// exec any module, call cleanup instead if the module throw
-		log([this, id](log_base& os){
+		// exec the modules in this thread as long as the run does not have
+		// to wait for the previous run, continue in the thread_pool
+		// otherwise
+		return log([this, id = state->context.id](log_base& os){
 			os << "id(" << id << ") chain '" << name << "'";
-		}, [this, id, run]{
-			try{
-				for(std::size_t i = 0; i < modules_.size(); ++i){
-					modules_[i]->set_id(chain_key(), id);
-					process_module(i, run, [](chain& c, std::size_t i){
-						c.modules_[i]->exec(chain_key());
-					}, "exec");
+		}, [this, &state, &future]{
+			start_run(state, true);
+
+			// a worker thread executes other tasks while waiting
+			if(pool_.is_worker()){
+				pool_.run_until([&state]{ return state->done.load(); });
+			}
+
+			// rethrow the exception of a module
+			return future.get();
+		});
+	}
+
+
+	std::future< bool > chain::exec_async(){
+		auto state = new_run();
+		if(!state){
+			std::promise< bool > rejected;
+			rejected.set_value(false);
+			return rejected.get_future();
+		}
+
+		auto future = state->promise.get_future();
+
+		log([this, &state](log_base& os){
+			os << "id(" << state->context.id << ") chain '" << name
+				<< "' exec_async";
+		});
+
+		start_run(state, false);
+
+		return future;
+	}
+
+
+	void chain::mark_demanded(exec_context& context)const{
+		// the readers of a module come after it in the chain, so go
+		// backward
+		for(std::size_t i = plan_.size(); i-- > 0;){
+			auto const consumers = plan_.consumers(i);
+			if(consumers.empty()) continue;
+
+			bool demanded = false;
+			for(auto const& consumer: consumers){
+				if(!context.is_demanded(consumer.module)) continue;
+
+				auto const& input = plan_.input(consumer, context.run);
+				if(input.demands(context.id)){
+					demanded = true;
+					break;
+				}
+			}
+
+			context.set_demanded(i, demanded);
+		}
+	}
+
+
+	void chain::skip_dependents(exec_context& context, std::size_t i)const{
+		for(auto const& consumer: plan_.consumers(i)){
+			if(!context.is_demanded(consumer.module)) continue;
+
+			context.set_demanded(consumer.module, false);
+			skip_dependents(context, consumer.module);
+		}
+	}
+
+
+	void chain::start_run(
+		std::shared_ptr< run_state > const& state,
+		bool exec_inline
+	){
+		std::size_t next = plan_.size();
+		for(auto i: plan_.roots()){
+			if(!enter_module(state, i)) continue;
+
+			if(exec_inline && next == plan_.size() && runs_here(i)){
+				next = i;
+			}else{
+				post_steps(state, i);
+			}
+		}
+
+		if(next < plan_.size()) exec_steps(state, next);
+	}
+
+
+	bool chain::enter_module(
+		std::shared_ptr< run_state > const& state,
+		std::size_t i
+	){
+		auto continuation = [this, state, i]{ post_steps(state, i); };
+		if(plan_[i].ordered){
+			return ready_run_[i].async_wait(
+				state->context.run, std::move(continuation));
+		}
+
+		return exclusive(i, state->context.run).async_lock(
+			std::move(continuation));
+	}
+
+
+	void chain::leave_module(
+		std::shared_ptr< run_state > const& state,
+		std::size_t i
+	){
+		if(plan_[i].ordered){
+			ready_run_[i].release(state->context.run);
+		}else{
+			exclusive(i, state->context.run).unlock();
+		}
+	}
+
+
+	void chain::verify_no_stage_thread(char const* what)const{
+		auto const current = stage_thread::current();
+		if(current == nullptr) return;
+
+		for(auto const& stage: stages_){
+			if(stage.get() != current) continue;
+
+			throw std::logic_error("chain '" + name + "': " + what +
+				" in stage thread '" + stage->name + "' of the chain could "
+				"deadlock, use exec_async()");
+		}
+	}
+
+
+	void chain::post_steps(
+		std::shared_ptr< run_state > const& state,
+		std::size_t i
+	){
+		auto task = [this, state, i]{ exec_steps(state, i); };
+		if(auto const stage = module_stages_[i]){
+			stage->post(std::move(task));
+		}else{
+			pool_.post(std::move(task));
+		}
+	}
+
+
+	void chain::exec_steps(
+		std::shared_ptr< run_state > const& state,
+		std::size_t i
+	){
+		for(;;){
+			// exec the module, cleanup instead if a module did throw or
+			// if nobody needs its data in this run
+			bool done = false;
+			bool const skip = !state->context.is_demanded(i);
+			if(!skip && state->start()){
+				auto status = run_status::proceed;
+				try{
+					run_module(i, *state,
+						[&state, &status](module_base& module){
+							status = module.exec(chain_key(), state->context);
+						}, "exec");
+					done = true;
+				}catch(...){
+					state->set_exception(std::current_exception());
 				}
-			}catch(...){
-				// cleanup and unlock all executions
-				for(std::size_t i = 0; i < ready_run_.size(); ++i){
-					// exec was successful
-					if(ready_run_[i] >= run + 1) continue;
-
-					process_module(i, run, [id](chain& c, std::size_t i){
-						c.modules_[i]->cleanup(chain_key(), id);
-					}, "cleanup");
+
+				// the module stopped the run without exception
+				if(done && status == run_status::abort_run){
+					state->failed.store(true, std::memory_order_release);
+				}else if(done && status == run_status::skip_rest){
+					skip_dependents(state->context, i);
 				}
+			}
 
-				// rethrow exception
-				throw;
+			if(!done){
+				run_module(i, *state, [&state](module_base& module){
+					module.cleanup(chain_key(), state->context);
+				}, skip ? "skip" : "cleanup");
 			}
-		});
+
+			leave_module(state, i);
+
+			// continue in this thread with the first module that is ready,
+			// post the others to the thread_pool
+			std::size_t next = plan_.size();
+			for(auto j: plan_.successors(i)){
+				if(state->pending[j].fetch_sub(1) != 1) continue;
+				if(!enter_module(state, j)) continue;
+
+				if(next == plan_.size() && runs_here(j)){
+					next = j;
+				}else{
+					post_steps(state, j);
+				}
+			}
+
+			if(state->remaining.fetch_sub(1) == 1) break;
+
+			if(next == plan_.size()) return;
+			i = next;
+		}
+
+		// a dropped run did give its place to a newer run
+		bool const dropped = state->is_dropped();
+		if(!dropped) free_place();
+
+		// aborted and dropped runs are failed without exception
+		if(state->exception){
+			state->promise.set_exception(state->exception);
+		}else{
+			state->promise.set_value(
+				!state->failed.load(std::memory_order_acquire));
+		}
+
+		// wake exec() if it waits in a worker thread
+		state->done.store(true);
+		pool_.wake_helpers();
 	}
 
 
-	void chain::enable(){
-		std::unique_lock< std::mutex > lock(enable_mutex_);
-		if(enabled_) return;
+	bool chain::admit(){
+		if(try_take_place()) return true;
+
+		// latest wins mode takes the place of a pending run first
+		auto const latest_wins = is_latest_wins();
+		if(latest_wins && drop_oldest_pending(coalesced_runs_)) return true;
+
+		auto const policy = overload_policy_.load(std::memory_order_relaxed);
+		if(policy == overload_policy::fail){
+			++rejected_runs_;
+			return false;
+		}
+
+		auto const ready = [this, policy, latest_wins]{
+			return try_take_place()
+				|| (latest_wins && drop_oldest_pending(coalesced_runs_))
+				|| (policy == overload_policy::drop_oldest
+					&& drop_oldest_pending(dropped_runs_));
+		};
+
+		// a worker thread executes other tasks while waiting
+		if(pool_.is_worker()){
+			pool_.run_until(ready);
+			return true;
+		}
+
+		verify_no_stage_thread("a wait for a free place");
+
+		std::unique_lock< std::mutex > lock(place_mutex_);
+		++place_waiters_;
+		place_cv_.wait(lock, ready);
+		--place_waiters_;
+		return true;
+	}
+
+
+	bool chain::try_take_place()noexcept{
+		auto const max = max_in_flight_.load(std::memory_order_relaxed);
+		auto count = in_flight_.load();
+		while(max == 0 || count < max){
+			if(in_flight_.compare_exchange_weak(count, count + 1)) return true;
+		}
+		return false;
+	}
+
+
+	void chain::free_place(){
+		in_flight_.fetch_sub(1);
+
+		// admit() waits in run_until() on worker threads
+		pool_.wake_helpers();
+
+		// the waiting thread increments place_waiters_ before it checks
+		// in_flight_, so one of both sees the change of the other
+		if(place_waiters_.load() == 0) return;
+
+		std::lock_guard< std::mutex > lock(place_mutex_);
+		place_cv_.notify_all();
+	}
+
+
+	bool chain::drop_oldest_pending(std::atomic< std::size_t >& counter){
+		std::lock_guard< std::mutex > lock(pending_mutex_);
+		while(!pending_runs_.empty()){
+			auto state = pending_runs_.front().lock();
+			pending_runs_.pop_front();
+
+			if(state && state->drop()){
+				++counter;
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	void chain::set_max_in_flight(std::size_t max, overload_policy policy){
+		{
+			std::lock_guard< std::mutex > lock(enable_mutex_);
+
+			// no run is in progress while the chain is disabled
+			if(max > 0 && !gate_.is_open()) set_slot_count(max);
+
+			overload_policy_.store(policy, std::memory_order_relaxed);
+			max_in_flight_.store(max, std::memory_order_relaxed);
+		}
+
+		// runs that wait in admit() may fit into the new limit
+		pool_.wake_helpers();
+
+		std::lock_guard< std::mutex > lock(place_mutex_);
+		place_cv_.notify_all();
+	}
+
+
+	void chain::set_slot_count(std::size_t count){
+		for(auto& replicas: modules_){
+			for(auto& module: replicas){
+				for(auto& input: module->inputs(make_creator_key())){
+					input.get().set_slot_count(make_creator_key(), count);
+				}
+			}
+		}
+	}
 
-		enable_cv_.wait(lock, [this]{ return exec_calls_count_ == 0; });
+
+	void chain::enable(){
+		std::lock_guard< std::mutex > lock(enable_mutex_);
+		if(gate_.is_open()) return;
 
 		log([this](log_base& os){ os << "chain '" << name << "' enable"; },
 			[this]{
 				std::size_t i = 0;
+				std::size_t r = 0;
 				try{
 					// enable all modules
 					for(; i < modules_.size(); ++i){
-						log([this, i](log_base& os){
-								os << "chain '" << name << "' module '"
-									<< modules_[i]->name << "' enable";
-							}, [this, i]{
-								modules_[i]->enable(chain_key());
-							});
+						for(r = 0; r < modules_[i].size(); ++r){
+							log([this, i](log_base& os){
+									os << "chain '" << name << "' module '"
+										<< modules_[i].front()->name
+										<< "' enable";
+								}, [this, i, r]{
+									modules_[i][r]->enable(chain_key());
+								});
+						}
 					}
 				}catch(...){
 					// disable all modules until the one who throw
-					for(std::size_t j; j < i; ++j){
-						log([this, i, j](log_base& os){
-								os << "chain '" << name << "' module '"
-									<< modules_[j]->name
-									<< "' disable because of exception while "
-									<< "enable module '" << modules_[i]->name
-									<< "'";
-							}, [this, j]{
-								modules_[j]->disable(chain_key());
-							});
+					for(std::size_t j = 0; j <= i; ++j){
+						auto const count = j < i ? modules_[j].size() : r;
+						for(std::size_t k = 0; k < count; ++k){
+							log([this, i, j](log_base& os){
+									os << "chain '" << name << "' module '"
+										<< modules_[j].front()->name
+										<< "' disable because of exception "
+										<< "while enable module '"
+										<< modules_[i].front()->name << "'";
+								}, [this, j, k]{
+									modules_[j][k]->disable(chain_key());
+								});
+						}
 					}
 
 					// rethrow exception
@@ -156,52 +777,49 @@ namespace disposer{
 				}
 			});
 
-		enabled_ = true;
+		gate_.open();
 	}
 
 
 	void chain::disable()noexcept{
-		std::unique_lock< std::mutex > lock(enable_mutex_);
-		if(!enabled_.exchange(false)) return;
+		std::lock_guard< std::mutex > lock(enable_mutex_);
+		if(!gate_.is_open()) return;
 
-		enable_cv_.wait(lock, [this]{ return exec_calls_count_ == 0; });
+		// let no more runs start and wait for the active ones
+		gate_.close();
 
 		log([this](log_base& os){ os << "chain '" << name << "' disable"; },
 			[this]{
 				// disable all modules
-				for(std::size_t i = 0; i < modules_.size(); ++i){
-					log([this, i](log_base& os){
-							os << "chain '" << name << "' module '"
-								<< modules_[i]->name << "' disable";
-						}, [this, i]{
-							modules_[i]->disable(chain_key());
-						});
+				for(auto& replicas: modules_){
+					for(auto& module: replicas){
+						log([this, &module](log_base& os){
+								os << "chain '" << name << "' module '"
+									<< module->name << "' disable";
+							}, [&module]{
+								module->disable(chain_key());
+							});
+					}
 				}
 			});
 	}
 
 
 	template < typename F >
-	void chain::process_module(
+	void chain::run_module(
 		std::size_t const i,
-		std::size_t const run,
+		run_state const& state,
 		F const& action,
 		char const* const action_name
 	){
-		// lock mutex and wait for the previous run to be ready
-		std::unique_lock< std::mutex > lock(module_mutexes_[i]);
-		module_cv_.wait(lock, [this, i, run]{ return ready_run_[i] == run; });
+		auto& module = plan_.module(i, state.context.run);
 
 		// exec or cleanup the module
-		log([this, i, action_name](log_base& os){
-			os << "id(" << modules_[i]->id << "." << i << ") " << action_name
-				<< " chain '" << modules_[i]->chain << "' module '"
-				<< modules_[i]->name << "'";
-		}, [this, i, &action]{ action(*this, i); });
-
-		// make module ready
-		ready_run_[i] = run + 1;
-		module_cv_.notify_all();
+		log([&module, &state, i, action_name](log_base& os){
+			os << "id(" << state.context.id << "." << i << ") " << action_name
+				<< " chain '" << module.chain << "' module '"
+				<< module.name << "'";
+		}, [&module, &action]{ action(module); });
 	}
 
 
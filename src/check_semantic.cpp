@@ -95,6 +95,31 @@ namespace disposer{
 					);
 				}
 
+				std::set< std::string > parameters;
+				for(auto& param: module.parameters){
+					if(
+						param.key != "replicas" &&
+						param.key != "memory_resource" &&
+						param.key != "ordered" &&
+						param.key != "stage" &&
+						param.key != "cpus"
+					){
+						throw std::logic_error(
+							"In chain '" + chain.name + "' module '" +
+							module.name + "': Unknown module parameter '" +
+							param.key + "'"
+						);
+					}
+
+					if(!parameters.insert(param.key).second){
+						throw std::logic_error(
+							"In chain '" + chain.name + "' module '" +
+							module.name + "': Duplicate parameter '" +
+							param.key + "'"
+						);
+					}
+				}
+
 				std::set< std::string > inputs;
 				for(auto& input: module.inputs){
 					if(variables.find(input.variable) == variables.end()){
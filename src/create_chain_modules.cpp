@@ -4,6 +4,7 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 
@@ -21,11 +22,17 @@ namespace disposer{
 namespace disposer{ namespace{
 
 
-	/// \brief A reference to the output with last_use flag
-	using output_pair = std::pair< output_base&, bool >;
+	/// \brief References to the output of all replicas with last_use flag
+	struct output_replicas{
+		std::vector< std::reference_wrapper< output_base > > outputs;
+		bool last_use;
+
+		/// \brief true if the module puts one id per run
+		bool single_value;
+	};
 
 	/// \brief Map from a variable name to an output
-	using variables_map = std::map< std::string, output_pair >;
+	using variables_map = std::map< std::string, output_replicas >;
 
 
 	auto find(module_base::input_list& container, std::string const& data){
@@ -73,18 +80,74 @@ namespace disposer{ namespace{
 		}
 	}
 
+	std::size_t replica_count(
+		types::merge::chain const& config_chain,
+		types::merge::chain_module const& config_module
+	){
+		auto iter = config_module.parameters.find("replicas");
+		if(iter == config_module.parameters.end()) return 1;
+
+		auto const& value = iter->second;
+		bool const is_number = !value.empty() && std::all_of(
+			value.begin(), value.end(),
+			[](char c){ return c >= '0' && c <= '9'; });
+
+		std::size_t count = 0;
+		if(is_number){
+			try{
+				count = std::stoul(value);
+			}catch(std::out_of_range const&){}
+		}
+
+		if(count == 0){
+			throw std::logic_error(
+				"In chain '" + config_chain.name + "' module '" +
+				config_module.module.first + "': Parameter 'replicas' must "
+				"be a positive number, but is '" + value + "'"
+			);
+		}
+
+		return count;
+	}
+
+	std::pmr::memory_resource& module_memory_resource(
+		types::merge::chain const& config_chain,
+		types::merge::chain_module const& config_module,
+		memory_resources const& resources
+	){
+		auto iter = config_module.parameters.find("memory_resource");
+		if(iter == config_module.parameters.end()){
+			return resources.get(config_chain.memory_resource);
+		}
+
+		try{
+			return resources.get(iter->second);
+		}catch(std::exception const& error){
+			throw std::logic_error(
+				"In chain '" + config_chain.name + "' module '" +
+				config_module.module.first + "': " + error.what()
+			);
+		}
+	}
+
 	auto create_modules(
 		module_maker_list const& maker_list,
 		types::merge::chain const& config_chain,
+		data_pools& pools,
+		memory_resources const& resources,
 		variables_map& variables
 	){
-		std::vector< module_ptr > modules;
+		std::vector< module_replicas > modules;
 
 		for(std::size_t i = 0; i < config_chain.modules.size(); ++i){
 			auto& config_module = config_chain.modules[i];
+			auto const count = replica_count(config_chain, config_module);
+			auto& resource =
+				module_memory_resource(config_chain, config_module, resources);
 
-			log([&config_module](log_base& os){
+			log([&config_module, count](log_base& os){
 				os << "create module '" << config_module.module.first << "'";
+				if(count > 1) os << " with " << count << " replicas";
 			}, [&](){
 				io_list config_inputs;
 				for(auto& config_input: config_module.inputs){
@@ -96,29 +159,54 @@ namespace disposer{ namespace{
 					config_outputs.emplace(config_output.name);
 				}
 
-				modules.push_back(create_module(maker_list, {
-					config_module.module.second.type_name,
-					config_chain.name,
-					config_module.module.first,
-					i,
-					std::move(config_inputs),
-					std::move(config_outputs),
-					config_module.module.second.parameters
-				}));
-
-				auto& module = *modules.back();
+				modules.emplace_back();
+				auto& replicas = modules.back();
+				for(std::size_t r = 0; r < count; ++r){
+					replicas.push_back(create_module(maker_list, {
+						config_module.module.second.type_name,
+						config_chain.name,
+						config_module.module.first,
+						i,
+						config_inputs,
+						config_outputs,
+						config_module.module.second.parameters
+					}));
+
+					auto& module = *replicas.back();
+					for(auto& input: module.inputs(make_creator_key())){
+						input.get().set_data_pools(
+							make_creator_key(), pools, resource);
+						input.get().set_module_number(make_creator_key(), i);
+						input.get().set_module_context(
+							make_creator_key(),
+							module.context(make_creator_key()));
+					}
+					for(auto& output: module.outputs(make_creator_key())){
+						output.get().set_data_pools(
+							make_creator_key(), pools, resource);
+						output.get().set_id_increase(
+							make_creator_key(), module.id_increase);
+						output.get().set_module_context(
+							make_creator_key(),
+							module.context(make_creator_key()));
+					}
+				}
 
 				// save output variable names
 				for(auto& config_output: config_module.outputs){
-					auto& output = find(
-							module.outputs(make_creator_key()),
-							config_output.name
-						).get();
-
-					variables.emplace(
-						config_output.variable,
-						std::pair< output_base&, bool >(output, true)
-					);
+					auto& target = variables.emplace(
+							config_output.variable,
+							output_replicas{
+								{}, true, replicas.front()->id_increase == 1
+							}
+						).first->second;
+
+					for(auto& module: replicas){
+						target.outputs.push_back(find(
+								module->outputs(make_creator_key()),
+								config_output.name
+							));
+					}
 				}
 			});
 		}
@@ -128,95 +216,104 @@ namespace disposer{ namespace{
 
 	void enable_output_types(
 		types::merge::chain const& config_chain,
-		std::vector< module_ptr > const& modules,
+		std::vector< module_replicas > const& modules,
 		variables_map const& variables
 	){
 		// go through all modules and enable output types in the target inputs
-		auto module_ptr_iter = modules.begin();
+		auto replicas_iter = modules.begin();
 		for(auto& config_module: config_chain.modules){
-			auto& module = **module_ptr_iter++;
+			auto& replicas = *replicas_iter++;
 
 			log([&config_module](log_base& os){
 				os << "enable input and output types in module '"
 					<< config_module.module.first << "'";
 			}, [&](){
-				// config_module.inputs containes all active input
-				// names
-				for(auto& config_input: config_module.inputs){
-					auto output_iter = variables.find(config_input.variable);
-					assert(output_iter != variables.end());
-
-					auto& output = output_iter->second.first;
-					auto& input = find(
-							module.inputs(make_creator_key()),
-							config_input.name
-						).get();
-
-					// try to enable the types from output in input
-					if(!input.enable_types(
-						make_creator_key(), output.active_types())
-					){
-						std::ostringstream os;
-						os << "In chain '" << config_chain.name << "' module '"
-							<< module.name << "': Variable '"
-							<< config_input.variable
-							<< "' is incompatible with input '"
-							<< config_input.name << "'" << " (active '"
-							<< config_input.variable << "' types: ";
-
-						bool first = true;
-						for(auto& type: output.active_types()){
-							if(first){
-								first = false;
-							}else{
-								os << ", ";
+				for(auto& module_ptr: replicas){
+					auto& module = *module_ptr;
+
+					// config_module.inputs containes all active input
+					// names
+					for(auto& config_input: config_module.inputs){
+						auto output_iter =
+							variables.find(config_input.variable);
+						assert(output_iter != variables.end());
+
+						// all replicas have the same active types
+						auto& output =
+							output_iter->second.outputs.front().get();
+						auto& input = find(
+								module.inputs(make_creator_key()),
+								config_input.name
+							).get();
+
+						// try to enable the types from output in input
+						if(!input.enable_types(
+							make_creator_key(), output.active_types())
+						){
+							std::ostringstream os;
+							os << "In chain '" << config_chain.name
+								<< "' module '" << module.name
+								<< "': Variable '" << config_input.variable
+								<< "' is incompatible with input '"
+								<< config_input.name << "'" << " (active '"
+								<< config_input.variable << "' types: ";
+
+							bool first = true;
+							for(auto& type: output.active_types()){
+								if(first){
+									first = false;
+								}else{
+									os << ", ";
+								}
+
+								os << "'" << type.pretty_name() << "'";
 							}
 
-							os << "'" << type.pretty_name() << "'";
-						}
+							os << "; possible '" << config_input.name
+								<< "' types: ";
 
-						os << "; possible '" << config_input.name
-							<< "' types: ";
+							first = true;
+							for(auto& type: input.types()){
+								if(first){
+									first = false;
+								}else{
+									os << ", ";
+								}
 
-						first = true;
-						for(auto& type: input.types()){
-							if(first){
-								first = false;
-							}else{
-								os << ", ";
+								os << "'" << type.pretty_name() << "'";
 							}
 
-							os << "'" << type.pretty_name() << "'";
-						}
-
-						os << ")";
+							os << ")";
 
-						throw std::logic_error(os.str());
+							throw std::logic_error(os.str());
+						}
 					}
-				}
-
-				log([&config_module](log_base& os){
-					os << "call input_ready() in module '"
-						<< config_module.module.first << "'";
-				}, [&module](){
-					module.input_ready(make_creator_key());
-				});
-
-				// config_module.outputs containes all active output names
-				for(auto& config_output: config_module.outputs){
-					auto output_iter = variables.find(config_output.variable);
-					assert(output_iter != variables.end());
-
-					auto& output = output_iter->second.first;
 
-					if(output.active_types().empty()){
-						std::ostringstream os;
-						os << "In chain '" << config_chain.name << "' module '"
-							<< module.name << "': Output '" + config_output.name
-							<< "' (Variable: '" << config_output.variable
-							<< "') has no active output types";
-
-						throw std::logic_error(os.str());
+					log([&config_module](log_base& os){
+						os << "call input_ready() in module '"
+							<< config_module.module.first << "'";
+					}, [&module](){
+						module.input_ready(make_creator_key());
+					});
+
+					// config_module.outputs containes all active output
+					// names
+					for(auto& config_output: config_module.outputs){
+						auto& output = find(
+								module.outputs(make_creator_key()),
+								config_output.name
+							).get();
+
+						if(output.active_types().empty()){
+							std::ostringstream os;
+							os << "In chain '" << config_chain.name
+								<< "' module '" << module.name << "': Output '"
+								<< config_output.name << "' (Variable: '"
+								<< config_output.variable
+								<< "') has no active output types";
+
+							throw std::logic_error(os.str());
+						}
 					}
 				}
 			});
@@ -225,16 +322,16 @@ namespace disposer{ namespace{
 
 	void connect_modules(
 		types::merge::chain const& config_chain,
-		std::vector< module_ptr > const& modules,
+		std::vector< module_replicas > const& modules,
 		variables_map& variables
 	){
 		namespace adaptors = boost::adaptors;
 
 		// go backward through all modules, because of the last_use information
-		auto module_ptr_iter = modules.end();
+		auto replicas_iter = modules.end();
 		for(auto& config_module: adaptors::reverse(config_chain.modules)){
-			--module_ptr_iter;
-			auto& module = **module_ptr_iter;
+			--replicas_iter;
+			auto& replicas = *replicas_iter;
 
 			log([&config_module](log_base& os){
 				os << "connect inputs of module '" << config_module.module.first
@@ -245,17 +342,28 @@ namespace disposer{ namespace{
 					auto output_iter = variables.find(config_input.variable);
 					assert(output_iter != variables.end());
 
-					auto& output = output_iter->second.first;
-					auto& last_use = output_iter->second.second;
-
-					auto& input = find(
-							module.inputs(make_creator_key()),
-							config_input.name
-						).get();
+					auto& last_use = output_iter->second.last_use;
+
+					std::vector< std::reference_wrapper< input_base > > inputs;
+					for(auto& module: replicas){
+						inputs.push_back(find(
+								module->inputs(make_creator_key()),
+								config_input.name
+							));
+						inputs.back().get().set_single_value(
+							make_creator_key(),
+							output_iter->second.single_value);
+					}
 
-					// connect input to output
-					output.get_signal(make_creator_key())
-						.connect(input, last_use);
+					// connect the inputs of all replicas to the outputs of
+					// all replicas
+					for(auto& output: output_iter->second.outputs){
+						output.get().get_signal(make_creator_key()).connect(
+							output.get().types(),
+							std::vector(inputs),
+							last_use
+						);
+					}
 
 					// the next one is no more the last use of the variable
 					last_use = false;
@@ -271,13 +379,16 @@ namespace disposer{ namespace{
 namespace disposer{
 
 
-	std::vector< module_ptr > create_chain_modules(
+	std::vector< module_replicas > create_chain_modules(
 		module_maker_list const& maker_list,
-		types::merge::chain const& config_chain
+		types::merge::chain const& config_chain,
+		data_pools& pools,
+		memory_resources const& resources
 	){
 		variables_map variables;
 
-		auto modules = create_modules(maker_list, config_chain, variables);
+		auto modules = create_modules(
+			maker_list, config_chain, pools, resources, variables);
 
 		enable_output_types(config_chain, modules, variables);
 
@@ -287,4 +398,89 @@ namespace disposer{
 	}
 
 
+	std::pmr::vector< std::pmr::vector< consumer > > module_consumers(
+		types::merge::chain const& config_chain,
+		std::vector< module_replicas > const& modules,
+		std::pmr::memory_resource& resource
+	){
+		auto const& config_modules = config_chain.modules;
+
+		// map from variable to producing module
+		std::map< std::string, std::size_t > producers;
+		for(std::size_t i = 0; i < config_modules.size(); ++i){
+			for(auto& config_output: config_modules[i].outputs){
+				producers.emplace(config_output.variable, i);
+			}
+		}
+
+		std::pmr::vector< std::pmr::vector< consumer > >
+			result(config_modules.size(), &resource);
+		for(std::size_t i = 0; i < config_modules.size(); ++i){
+			auto& inputs = modules[i].front()->inputs(make_creator_key());
+			for(auto& config_input: config_modules[i].inputs){
+				auto producer = producers.find(config_input.variable);
+				assert(producer != producers.end());
+
+				auto const iter = std::find_if(inputs.begin(), inputs.end(),
+					[&config_input](input_base const& input){
+						return input.name == config_input.name;
+					});
+				assert(iter != inputs.end());
+
+				result[producer->second].push_back(
+					{i, static_cast< std::size_t >(iter - inputs.begin())});
+			}
+		}
+
+		return result;
+	}
+
+
+	std::pmr::vector< std::pmr::vector< std::size_t > > module_successors(
+		types::merge::chain const& config_chain,
+		std::pmr::memory_resource& resource
+	){
+		auto const& modules = config_chain.modules;
+
+		// map from variable to producing module
+		std::map< std::string, std::size_t > producers;
+		for(std::size_t i = 0; i < modules.size(); ++i){
+			for(auto& config_output: modules[i].outputs){
+				producers.emplace(config_output.variable, i);
+			}
+		}
+
+		// map from variable to reading modules in chain order
+		std::map< std::string, std::vector< std::size_t > > readers;
+		for(std::size_t i = 0; i < modules.size(); ++i){
+			for(auto& config_input: modules[i].inputs){
+				readers[config_input.variable].push_back(i);
+			}
+		}
+
+		std::pmr::vector< std::pmr::vector< std::size_t > >
+			result(modules.size(), &resource);
+		for(auto& [variable, list]: readers){
+			auto producer = producers.find(variable);
+			assert(producer != producers.end());
+
+			for(auto i: list){
+				result[producer->second].push_back(i);
+			}
+
+			// the last reader moves the data
+			for(auto i: list){
+				if(i != list.back()) result[i].push_back(list.back());
+			}
+		}
+
+		for(auto& list: result){
+			std::sort(list.begin(), list.end());
+			list.erase(std::unique(list.begin(), list.end()), list.end());
+		}
+
+		return result;
+	}
+
+
 }
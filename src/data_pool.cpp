@@ -0,0 +1,258 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/data_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+
+namespace disposer{
+
+
+	namespace{
+
+
+		/// \brief Alignment of all kept blocks
+		constexpr std::size_t block_align = alignof(std::max_align_t);
+
+
+		/// \brief Hands out the numbers of the thread lists
+		///
+		/// A thread gives its number back when it ends, so the numbers of
+		/// short living threads are reused.
+		class list_numbers{
+		public:
+			/// \brief Number for a new thread, thread_lists if all are
+			///        taken
+			std::size_t take(){
+				std::lock_guard< std::mutex > lock(mutex_);
+				if(!free_.empty()){
+					auto const number = free_.back();
+					free_.pop_back();
+					return number;
+				}
+
+				return next_ < data_pool::thread_lists
+					? next_++
+					: data_pool::thread_lists;
+			}
+
+			/// \brief Give back the number of an ending thread
+			void give_back(std::size_t number){
+				if(number == data_pool::thread_lists) return;
+
+				std::lock_guard< std::mutex > lock(mutex_);
+				free_.push_back(number);
+			}
+
+		private:
+			std::mutex mutex_;
+			std::size_t next_ = 0;
+			std::vector< std::size_t > free_;
+		};
+
+		list_numbers& numbers(){
+			static list_numbers numbers;
+			return numbers;
+		}
+
+
+		/// \brief The thread list number of a thread
+		struct thread_number{
+			thread_number(): value(numbers().take()) {}
+
+			~thread_number(){
+				try{ numbers().give_back(value); }catch(...){}
+			}
+
+			std::size_t const value;
+		};
+
+		thread_local thread_number const current_number;
+
+
+		/// \brief Add one to a counter that only the calling thread writes
+		void count(std::atomic< std::size_t >& counter)noexcept{
+			counter.store(counter.load(std::memory_order_relaxed) + 1,
+				std::memory_order_release);
+		}
+
+
+	}
+
+
+	data_pool_ptr data_pool::make(
+		std::pmr::memory_resource& upstream,
+		std::size_t capacity
+	){
+		return data_pool_ptr(
+			new data_pool(upstream, capacity), &data_pool::release);
+	}
+
+
+	data_pool::data_pool(
+		std::pmr::memory_resource& upstream,
+		std::size_t capacity
+	):
+		upstream_(upstream),
+		capacity_(capacity),
+		block_size_(0),
+		thread_lists_(std::make_unique< thread_list[] >(thread_lists)),
+		free_(&upstream),
+		hits_(0),
+		misses_(0),
+		frees_(0)
+	{
+		free_.reserve(capacity_);
+	}
+
+	data_pool::~data_pool(){
+		auto const block_size = block_size_.load();
+		for(std::size_t i = 0; i < thread_lists; ++i){
+			auto& list = thread_lists_[i];
+			for(std::size_t j = 0; j < list.count; ++j){
+				upstream_.deallocate(list.blocks[j], block_size, block_align);
+			}
+		}
+
+		for(auto block: free_){
+			upstream_.deallocate(block, block_size, block_align);
+		}
+	}
+
+
+	void data_pool::release(data_pool* pool)noexcept{
+		// blocks in use need the pool to be given back, keep it then
+		if(pool->in_use() == 0) delete pool;
+	}
+
+
+	void* data_pool::allocate(std::size_t size, std::size_t align){
+		auto block_size = block_size_.load(std::memory_order_relaxed);
+		if(block_size == 0 && align <= block_align){
+			// the first allocation sets the size, or gets the size of a
+			// concurrent one
+			if(block_size_.compare_exchange_strong(block_size, size)){
+				block_size = size;
+			}
+		}
+
+		if(size == block_size && align <= block_align){
+			if(auto const list = local_list()){
+				if(list->count == 0) refill(*list);
+				if(list->count > 0){
+					count(list->hits);
+					return list->blocks[--list->count];
+				}
+			}else{
+				std::lock_guard< std::mutex > lock(mutex_);
+				if(!free_.empty()){
+					auto block = free_.back();
+					free_.pop_back();
+					hits_.fetch_add(1, std::memory_order_relaxed);
+					return block;
+				}
+			}
+		}
+
+		auto const block =
+			upstream_.allocate(size, std::max(align, block_align));
+		misses_.fetch_add(1, std::memory_order_relaxed);
+		return block;
+	}
+
+	void data_pool::deallocate(
+		void* block,
+		std::size_t size,
+		std::size_t align
+	)noexcept{
+		if(
+			size == block_size_.load(std::memory_order_relaxed) &&
+			align <= block_align
+		){
+			if(auto const list = local_list()){
+				if(list->count == thread_capacity) spill(*list);
+				list->blocks[list->count++] = block;
+				count(list->frees);
+				return;
+			}
+
+			std::lock_guard< std::mutex > lock(mutex_);
+			if(free_.size() < capacity_){
+				free_.push_back(block);
+				frees_.fetch_add(1, std::memory_order_release);
+				return;
+			}
+		}
+
+		upstream_.deallocate(block, size, std::max(align, block_align));
+		frees_.fetch_add(1, std::memory_order_release);
+	}
+
+
+	std::size_t data_pool::hits()const noexcept{
+		auto result = hits_.load(std::memory_order_acquire);
+		for(std::size_t i = 0; i < thread_lists; ++i){
+			result += thread_lists_[i].hits.load(std::memory_order_acquire);
+		}
+		return result;
+	}
+
+
+	data_pool::thread_list* data_pool::local_list()noexcept{
+		auto const number = current_number.value;
+		return number < thread_lists ? &thread_lists_[number] : nullptr;
+	}
+
+	void data_pool::refill(thread_list& list){
+		std::lock_guard< std::mutex > lock(mutex_);
+		auto const count = std::min(free_.size(), thread_capacity / 2);
+		std::copy(free_.end() - count, free_.end(), list.blocks);
+		free_.resize(free_.size() - count);
+		list.count = count;
+	}
+
+	void data_pool::spill(thread_list& list)noexcept{
+		auto const count = thread_capacity / 2;
+		auto const first = list.blocks + list.count - count;
+		list.count -= count;
+
+		std::lock_guard< std::mutex > lock(mutex_);
+		auto const kept = std::min(count, capacity_ - free_.size());
+		free_.insert(free_.end(), first, first + kept);
+
+		auto const block_size = block_size_.load(std::memory_order_relaxed);
+		for(auto iter = first + kept; iter != first + count; ++iter){
+			upstream_.deallocate(*iter, block_size, block_align);
+		}
+	}
+
+	std::size_t data_pool::in_use()const noexcept{
+		// the counters of blocks in use are read last, so a block given
+		// back concurrently is seen as in use at worst
+		std::size_t freed = frees_.load(std::memory_order_acquire);
+		for(std::size_t i = 0; i < thread_lists; ++i){
+			freed += thread_lists_[i].frees.load(std::memory_order_acquire);
+		}
+
+		return hits() + misses() - freed;
+	}
+
+
+	data_pool_ptr const& data_pools::get(
+		boost::typeindex::type_index const& type,
+		std::pmr::memory_resource& resource
+	){
+		auto& pool = pools_[key(type, &resource)];
+		if(!pool) pool = data_pool::make(resource);
+		return pool;
+	}
+
+
+}
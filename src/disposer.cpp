@@ -22,7 +22,9 @@ namespace disposer{
 
 		auto create_chains(
 			module_maker_list const& maker_list,
-			types::merge::config&& config
+			types::merge::config&& config,
+			thread_pool& pool,
+			memory_resources const& resources
 		){
 			std::unordered_map< std::string, chain > chains;
 			std::unordered_map< std::string, id_generator > id_generators;
@@ -51,7 +53,9 @@ namespace disposer{
 							maker_list,
 							config_chain,
 							id_generators[config_chain.id_generator],
-							group_iter->first
+							group_iter->first,
+							pool,
+							resources
 						)
 					).first;
 
@@ -71,7 +75,8 @@ namespace disposer{
 	}
 
 
-	disposer::disposer():
+	disposer::disposer(std::size_t thread_count):
+		pool_(thread_count),
 		declarant_(*this) {}
 
 	void module_declarant::operator()(
@@ -98,6 +103,17 @@ namespace disposer{
 		return declarant_;
 	}
 
+	void disposer::add_memory_resource(
+		std::string const& name,
+		std::pmr::memory_resource& resource
+	){
+		memory_resources_.add(name, resource);
+	}
+
+	void disposer::set_memory_resource(std::pmr::memory_resource& resource){
+		memory_resources_.set_default(resource);
+	}
+
 	void disposer::load(std::string const& filename){
 		auto config = log([&](log_base& os){
 				os << "parse '" << filename << "'";
@@ -116,7 +132,8 @@ namespace disposer{
 		log([](log_base& os){ os << "create chains"; },
 			[this, &merged_config](){
 				std::tie(chains_, id_generators_, groups_) =
-					create_chains(maker_list_, std::move(merged_config));
+					create_chains(maker_list_, std::move(merged_config),
+						pool_, memory_resources_);
 			});
 	}
 
@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/exec_context.hpp>
+
+#include <stdexcept>
+
+
+namespace disposer{
+
+
+	namespace{
+
+
+		/// \brief The context of the run the calling thread processes
+		thread_local exec_context* current_context = nullptr;
+
+
+	}
+
+
+	exec_context* exec_context::current()noexcept{
+		return current_context;
+	}
+
+	exec_context& exec_context::get(){
+		if(current_context == nullptr){
+			throw std::logic_error(
+				"the id is only available while a module processes a run");
+		}
+
+		return *current_context;
+	}
+
+
+	void* exec_context::arena::do_allocate(
+		std::size_t bytes,
+		std::size_t align
+	){
+		std::lock_guard< std::mutex > lock(mutex_);
+		return resource_.allocate(bytes, align);
+	}
+
+
+	exec_context_scope::exec_context_scope(exec_context& context)noexcept:
+		exec_context_scope(current_context, context) {}
+
+
+}
@@ -0,0 +1,42 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/exec_gate.hpp>
+
+
+namespace disposer{
+
+
+	void exec_gate::close(){
+		std::unique_lock< std::mutex > lock(mutex_);
+		state_.fetch_or(closed_bit, std::memory_order_acq_rel);
+		cv_.wait(lock, [this]{
+			return state_.load(std::memory_order_acquire) == closed_bit;
+		});
+	}
+
+
+	void exec_gate::leave()noexcept{
+		// fast path, nobody waits in close()
+		auto state = state_.load(std::memory_order_relaxed);
+		while((state & closed_bit) == 0){
+			if(state_.compare_exchange_weak(
+				state, state - 1, std::memory_order_release,
+				std::memory_order_relaxed
+			)) return;
+		}
+
+		// the gate might be destroyed as soon as close() returns, so
+		// decrement and notify while it is locked
+		std::lock_guard< std::mutex > lock(mutex_);
+		state_.fetch_sub(1, std::memory_order_acq_rel);
+		cv_.notify_all();
+	}
+
+
+}
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/execution_plan.hpp>
+#include <disposer/create_chain_modules.hpp>
+#include <disposer/module_base.hpp>
+
+#include <optional>
+#include <stdexcept>
+
+
+namespace disposer{
+
+
+	namespace{
+
+
+		/// \brief The chain module parameter 'ordered = true|false'
+		std::optional< bool > ordered_parameter(
+			types::merge::chain const& config_chain,
+			types::merge::chain_module const& config_module
+		){
+			auto iter = config_module.parameters.find("ordered");
+			if(iter == config_module.parameters.end()) return {};
+
+			auto const& value = iter->second;
+			if(value == "true") return true;
+			if(value == "false") return false;
+
+			throw std::logic_error(
+				"In chain '" + config_chain.name + "' module '" +
+				config_module.module.first + "': Parameter 'ordered' must "
+				"be 'true' or 'false', but is '" + value + "'"
+			);
+		}
+
+
+	}
+
+
+	execution_plan::execution_plan(
+		types::merge::chain const& config_chain,
+		std::vector< module_replicas > const& modules,
+		std::pmr::memory_resource& resource,
+		bool relaxed_order
+	):
+		steps_(&resource),
+		modules_(&resource),
+		successors_(&resource),
+		consumers_(&resource),
+		inputs_(&resource),
+		roots_(&resource),
+		id_increase_(1)
+	{
+		// the nested lists are only needed until the plan is flat
+		auto& temp = *std::pmr::get_default_resource();
+		auto const successors = module_successors(config_chain, temp);
+		auto const consumers = module_consumers(config_chain, modules, temp);
+
+		steps_.reserve(modules.size());
+		for(std::size_t i = 0; i < modules.size(); ++i){
+			auto const& replicas = modules[i];
+
+			steps_.push_back({
+				modules_.size(), replicas.size(), 0,
+				successors_.size(), 0,
+				consumers_.size(), 0,
+				true
+			});
+			auto& step = steps_.back();
+
+			for(auto& module: replicas) modules_.push_back(module.get());
+
+			successors_.insert(successors_.end(),
+				successors[i].begin(), successors[i].end());
+			step.successor_end = successors_.size();
+
+			// resolve the input of every replica of the reading module
+			for(auto const& consumer: consumers[i]){
+				consumers_.push_back({consumer.module, inputs_.size()});
+				for(auto& module: modules[consumer.module]){
+					inputs_.push_back(&module->inputs(make_creator_key())
+						[consumer.input].get());
+				}
+			}
+			step.consumer_end = consumers_.size();
+
+			// the final results are always delivered in run order
+			auto const ordered =
+				ordered_parameter(config_chain, config_chain.modules[i]);
+			step.ordered = !relaxed_order || consumers[i].empty() ||
+				ordered.value_or(false);
+
+			id_increase_ *= replicas.front()->id_increase;
+		}
+
+		for(auto& list: successors){
+			for(auto j: list) ++steps_[j].dependency_count;
+		}
+
+		for(std::size_t i = 0; i < steps_.size(); ++i){
+			if(steps_[i].dependency_count == 0) roots_.push_back(i);
+		}
+	}
+
+
+}
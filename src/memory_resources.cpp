@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/memory_resources.hpp>
+
+#include <stdexcept>
+
+
+namespace disposer{
+
+
+	void memory_resources::add(
+		std::string const& name,
+		std::pmr::memory_resource& resource
+	){
+		if(!resources_.emplace(name, &resource).second){
+			throw std::logic_error(
+				"Memory resource '" + name + "' is double registered!"
+			);
+		}
+	}
+
+	std::pmr::memory_resource& memory_resources::get(
+		std::string const& name
+	)const{
+		if(name.empty()) return *default_;
+
+		auto iter = resources_.find(name);
+		if(iter == resources_.end()){
+			throw std::logic_error(
+				"Memory resource '" + name + "' is unknown!"
+			);
+		}
+
+		return *iter->second;
+	}
+
+
+}
@@ -66,7 +66,11 @@ namespace disposer{
 			result.chains.emplace_back(types::merge::chain{
 				std::move(chain.name),
 				std::move(chain.id_generator).value_or(group),
-				group, {}
+				group, {},
+				std::move(chain.memory_resource).value_or(""),
+				std::move(chain.max_in_flight).value_or(""),
+				std::move(chain.overload_policy).value_or(""),
+				std::move(chain.run_order).value_or("")
 			});
 
 			auto& result_chain = result.chains.back();
@@ -78,8 +82,16 @@ namespace disposer{
 				assert(iter != result.modules.end());
 
 				result_chain.modules.emplace_back(types::merge::chain_module{
-					*iter, std::move(module.inputs), std::move(module.outputs)
+					*iter, std::move(module.inputs), std::move(module.outputs),
+					{}
 				});
+
+				for(auto& parameter: module.parameters){
+					result_chain.modules.back().parameters.emplace(
+						std::move(parameter.key),
+						std::move(parameter.value)
+					);
+				}
 			}
 		}
 
@@ -16,17 +16,31 @@ namespace disposer{
 		make_data const& data,
 		input_list&& inputs,
 		output_list&& outputs
+	):
+		module_base(data, 1, std::move(inputs), std::move(outputs)){}
+
+	module_base::module_base(
+		make_data const& data,
+		std::size_t id_increase,
+		input_list&& inputs,
+		output_list&& outputs
 	):
 		type_name(data.type_name),
 		chain(data.chain),
 		name(data.name),
 		number(data.number),
-		id_increase(1),
+		id_increase(id_increase),
 		id(id_),
-		id_(0),
 		inputs_(std::move(inputs)),
 		outputs_(std::move(outputs))
-		{}
+	{
+		if(id_increase == 0){
+			throw std::logic_error(
+				"Module '" + chain + "'.'" + name + "': id_increase must "
+				"not be 0"
+			);
+		}
+	}
 
 	module_base::module_base(
 		make_data const& data,
@@ -36,19 +50,12 @@ namespace disposer{
 		module_base(data, std::move(inputs), std::move(outputs)){}
 
 
-	void module_base::cleanup(chain_key, std::size_t id)noexcept{
-		for(auto& input: inputs_){
-			input.get().cleanup(module_base_key(), id);
-		}
-	}
-
-	void module_base::set_id(chain_key, std::size_t id){
-		id_ = id;
+	void module_base::cleanup(
+		chain_key,
+		exec_context const& context
+	)noexcept{
 		for(auto& input: inputs_){
-			input.get().set_id(module_base_key(), id);
-		}
-		for(auto& output: outputs_){
-			output.get().set_id(module_base_key(), id);
+			input.get().cleanup(module_base_key(), context.run);
 		}
 	}
 
@@ -51,6 +51,7 @@ BOOST_FUSION_ADAPT_STRUCT(
 BOOST_FUSION_ADAPT_STRUCT(
 	disposer::types::parse::chain_module,
 	name,
+	parameters,
 	inputs,
 	outputs
 )
@@ -60,6 +61,10 @@ BOOST_FUSION_ADAPT_STRUCT(
 	name,
 	group,
 	id_generator,
+	memory_resource,
+	max_in_flight,
+	overload_policy,
+	run_order,
 	modules
 )
 
@@ -510,6 +515,10 @@ namespace disposer{
 			x3::rule< outputs_tag, std::vector< types::parse::io > > const
 				outputs("outputs");
 
+			struct module_parameter_tag;
+			x3::rule< module_parameter_tag, types::parse::parameter > const
+				module_parameter("module_parameter");
+
 			struct chain_module_tag;
 			x3::rule< chain_module_tag, types::parse::chain_module > const
 				chain_module("chain_module");
@@ -528,6 +537,22 @@ namespace disposer{
 			x3::rule< id_generator_tag, std::string > const
 				id_generator("id_generator");
 
+			struct memory_resource_tag;
+			x3::rule< memory_resource_tag, std::string > const
+				memory_resource("memory_resource");
+
+			struct max_in_flight_tag;
+			x3::rule< max_in_flight_tag, std::string > const
+				max_in_flight("max_in_flight");
+
+			struct overload_policy_tag;
+			x3::rule< overload_policy_tag, std::string > const
+				overload_policy("overload_policy");
+
+			struct run_order_tag;
+			x3::rule< run_order_tag, std::string > const
+				run_order("run_order");
+
 			struct chains_tag;
 			x3::rule< chains_tag, types::parse::chains > const
 				chains("chains");
@@ -565,8 +590,14 @@ namespace disposer{
 				output_params
 			;
 
+			auto const module_parameter_def =
+				("\t\t\t" >> keyword >> *space >> '=') >
+					*space > value > separator
+			;
+
 			auto const chain_module_def =
 				("\t\t" > keyword > separator) >>
+				*module_parameter >>
 				-inputs >>
 				-outputs
 			;
@@ -580,6 +611,26 @@ namespace disposer{
 					('=' >> *space) > value > separator
 			;
 
+			auto const memory_resource_def =
+				("\t\tmemory_resource" >> *space) >
+					('=' >> *space) > value > separator
+			;
+
+			auto const max_in_flight_def =
+				("\t\tmax_in_flight" >> *space) >
+					('=' >> *space) > value > separator
+			;
+
+			auto const overload_policy_def =
+				("\t\toverload_policy" >> *space) >
+					('=' >> *space) > value > separator
+			;
+
+			auto const run_order_def =
+				("\t\trun_order" >> *space) >
+					('=' >> *space) > value > separator
+			;
+
 			auto const chain_params_def =
 				x3::expect[+chain_module]
 			;
@@ -587,6 +638,10 @@ namespace disposer{
 			auto const chain_def =
 				('\t' > (keyword >> *space) > -group > separator) >>
 				-id_generator >>
+				-memory_resource >>
+				-max_in_flight >>
+				-overload_policy >>
+				-run_order >>
 				chain_params
 			;
 
@@ -607,11 +662,16 @@ namespace disposer{
 				outputs,
 				input_params,
 				output_params,
+				module_parameter,
 				chain_module,
 				chain_params,
 				chain,
 				group,
 				id_generator,
+				memory_resource,
+				max_in_flight,
+				overload_policy,
+				run_order,
 				chains_params,
 				chains
 			)
@@ -662,6 +722,12 @@ namespace disposer{
 				}
 			};
 
+			struct module_parameter_tag: error_base{
+				virtual const char* message()const override{
+					return "a module parameter '\t\t\tname = value\n'";
+				}
+			};
+
 			struct chain_module_tag: error_base{
 				virtual const char* message()const override{
 					return "a module '\t\tmodule\n'";
@@ -687,6 +753,38 @@ namespace disposer{
 				}
 			};
 
+			struct memory_resource_tag: error_base{
+				virtual const char* message()const override{
+					return "a memory_resource line "
+						"'\t\tmemory_resource = name\n', "
+						"where memory_resource is a keyword";
+				}
+			};
+
+			struct max_in_flight_tag: error_base{
+				virtual const char* message()const override{
+					return "a max_in_flight line "
+						"'\t\tmax_in_flight = count\n', "
+						"where max_in_flight is a keyword";
+				}
+			};
+
+			struct overload_policy_tag: error_base{
+				virtual const char* message()const override{
+					return "a overload_policy line "
+						"'\t\toverload_policy = policy\n', "
+						"where overload_policy is a keyword";
+				}
+			};
+
+			struct run_order_tag: error_base{
+				virtual const char* message()const override{
+					return "a run_order line "
+						"'\t\trun_order = order\n', "
+						"where run_order is a keyword";
+				}
+			};
+
 
 		}
 
@@ -0,0 +1,143 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/sequence_barrier.hpp>
+
+#include <memory>
+
+
+namespace disposer{
+
+
+	struct sequence_barrier::waiter{
+		/// \brief The run the thread is waiting for
+		std::size_t const run;
+
+		/// \brief Next waiter in the list
+		waiter* next;
+
+		/// \brief The sleeping thread
+		std::condition_variable cv;
+
+		/// \brief Called instead of waking a thread if not empty
+		std::function< void() > continuation;
+	};
+
+
+	sequence_barrier::sequence_barrier(std::size_t lanes):
+		lanes_(lanes),
+		ready_run_(new std::atomic< std::size_t >[lanes]),
+		waiting_(0),
+		waiters_(nullptr),
+		wakeups_(0)
+	{
+		for(std::size_t i = 0; i < lanes_; ++i){
+			ready_run_[i].store(i, std::memory_order_relaxed);
+		}
+	}
+
+	sequence_barrier::~sequence_barrier(){
+		// continuations of runs that never passed
+		while(waiters_ != nullptr){
+			std::unique_ptr< waiter > w(waiters_);
+			waiters_ = w->next;
+		}
+	}
+
+
+	void sequence_barrier::push(waiter& w)noexcept{
+		w.next = waiters_;
+		waiters_ = &w;
+
+		// release() stores ready_run_ before it loads waiting_, we
+		// increment waiting_ before our caller loads ready_run_, so at
+		// least one of us sees the other
+		waiting_.fetch_add(1);
+	}
+
+	void sequence_barrier::erase(waiter& w)noexcept{
+		waiting_.fetch_sub(1, std::memory_order_relaxed);
+
+		for(auto* iter = &waiters_; ; iter = &(*iter)->next){
+			if(*iter != &w) continue;
+			*iter = w.next;
+			break;
+		}
+	}
+
+
+	void sequence_barrier::wait(std::size_t run){
+		auto& ready_run = cursor(run);
+		if(ready_run.load(std::memory_order_acquire) == run) return;
+
+		std::unique_lock< std::mutex > lock(mutex_);
+		waiter self{run, nullptr, {}, {}};
+		push(self);
+
+		while(ready_run.load() != run){
+			self.cv.wait(lock);
+			wakeups_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		erase(self);
+	}
+
+	bool sequence_barrier::async_wait(
+		std::size_t run,
+		std::function< void() >&& continuation
+	){
+		auto& ready_run = cursor(run);
+		if(ready_run.load(std::memory_order_acquire) == run) return true;
+
+		std::unique_ptr< waiter > self(
+			new waiter{run, nullptr, {}, std::move(continuation)});
+
+		std::lock_guard< std::mutex > lock(mutex_);
+		push(*self);
+
+		if(ready_run.load() == run){
+			erase(*self);
+			return true;
+		}
+
+		// owned by the list until release() removes it
+		self.release();
+		return false;
+	}
+
+	void sequence_barrier::release(std::size_t run){
+		auto const next = run + lanes_;
+		cursor(run).store(next);
+
+		if(waiting_.load() == 0) return;
+
+		std::unique_ptr< waiter > continuation;
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			for(auto w = waiters_; w != nullptr; w = w->next){
+				if(w->run != next) continue;
+
+				if(w->continuation){
+					erase(*w);
+					continuation.reset(w);
+				}else{
+					w->cv.notify_one();
+				}
+
+				break;
+			}
+		}
+
+		if(continuation){
+			wakeups_.fetch_add(1, std::memory_order_relaxed);
+			continuation->continuation();
+		}
+	}
+
+
+}
@@ -0,0 +1,147 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/stage_thread.hpp>
+
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+namespace disposer{
+
+
+	namespace{
+
+
+		/// \brief The stage thread of the calling thread
+		thread_local stage_thread const* current_stage = nullptr;
+
+
+	}
+
+
+	stage_thread::stage_thread(
+		std::string name,
+		std::vector< std::size_t > cpus
+	):
+		name(std::move(name)),
+		cpus_(std::move(cpus)),
+		shutdown_(false),
+		tasks_(0),
+		busy_time_(0),
+		thread_([this]{ work(); })
+	{
+		try{
+			pin();
+		}catch(...){
+			stop();
+			throw;
+		}
+	}
+
+	stage_thread::~stage_thread(){
+		stop();
+	}
+
+
+	stage_thread const* stage_thread::current()noexcept{
+		return current_stage;
+	}
+
+
+	void stage_thread::post(std::function< void() >&& task){
+		bool was_empty;
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			was_empty = task_queue_.empty();
+			task_queue_.push_back(std::move(task));
+		}
+
+		// the thread only sleeps if the queue was empty
+		if(was_empty) cv_.notify_one();
+	}
+
+
+	void stage_thread::work()noexcept{
+		current_stage = this;
+
+		std::deque< std::function< void() > > tasks;
+		for(;;){
+			{
+				std::unique_lock< std::mutex > lock(mutex_);
+				cv_.wait(lock, [this]{
+					return shutdown_ || !task_queue_.empty();
+				});
+
+				if(task_queue_.empty()) return;
+
+				// take all waiting tasks at once
+				tasks.swap(task_queue_);
+			}
+
+			for(auto& task: tasks){
+				tasks_.fetch_add(1, std::memory_order_relaxed);
+
+				auto const start = std::chrono::steady_clock::now();
+				task();
+				auto const end = std::chrono::steady_clock::now();
+
+				busy_time_.fetch_add(
+					std::chrono::duration_cast< std::chrono::nanoseconds >(
+						end - start).count(),
+					std::memory_order_relaxed);
+			}
+
+			tasks.clear();
+		}
+	}
+
+
+	void stage_thread::pin(){
+#ifdef __linux__
+		auto const handle = thread_.native_handle();
+
+		// Linux limits thread names to 15 characters
+		pthread_setname_np(handle, name.substr(0, 15).c_str());
+
+		if(cpus_.empty()) return;
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for(auto cpu: cpus_){
+			if(cpu >= CPU_SETSIZE){
+				throw std::runtime_error("stage '" + name + "': CPU " +
+					std::to_string(cpu) + " is out of range");
+			}
+			CPU_SET(cpu, &set);
+		}
+
+		if(pthread_setaffinity_np(handle, sizeof(set), &set) != 0){
+			throw std::runtime_error("stage '" + name + "': Can not pin "
+				"the thread to its CPUs");
+		}
+#endif
+	}
+
+
+	void stage_thread::stop()noexcept{
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			shutdown_ = true;
+		}
+		cv_.notify_one();
+
+		thread_.join();
+	}
+
+
+}
@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/thread_pool.hpp>
+
+#include <algorithm>
+
+
+namespace disposer{
+
+
+	namespace{
+
+
+		/// \brief The pool of the calling thread, nullptr if no worker
+		thread_local thread_pool const* current_pool = nullptr;
+
+		/// \brief The worker index of the calling thread
+		thread_local std::size_t current_index = 0;
+
+
+	}
+
+
+	thread_pool::thread_pool(std::size_t thread_count):
+		pending_(0),
+		sleeping_(0),
+		helping_(0),
+		shutdown_(false)
+	{
+		if(thread_count == 0){
+			thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		workers_.reserve(thread_count);
+		for(std::size_t i = 0; i < thread_count; ++i){
+			workers_.push_back(std::make_unique< task_queue >());
+		}
+
+		threads_.reserve(thread_count);
+		for(std::size_t i = 0; i < thread_count; ++i){
+			threads_.emplace_back([this, i]{ work(i); });
+		}
+	}
+
+	thread_pool::~thread_pool(){
+		{
+			std::lock_guard< std::mutex > lock(sleep_mutex_);
+			shutdown_ = true;
+		}
+		sleep_cv_.notify_all();
+
+		for(auto& thread: threads_) thread.join();
+	}
+
+
+	bool thread_pool::is_worker()const noexcept{
+		return current_pool == this;
+	}
+
+
+	void thread_pool::post(std::function< void() >&& task){
+		auto& queue = is_worker() ? *workers_[current_index] : injected_;
+
+		// count the task before pop() can take it, so pending_ never
+		// wraps below 0
+		pending_.fetch_add(1);
+		try{
+			std::lock_guard< std::mutex > lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}catch(...){
+			pending_.fetch_sub(1);
+			throw;
+		}
+
+		// work() increments sleeping_ before it loads pending_, we
+		// increment pending_ before we load sleeping_, so at least one of
+		// us sees the other
+		if(sleeping_.load() == 0) return;
+
+		std::lock_guard< std::mutex > lock(sleep_mutex_);
+		sleep_cv_.notify_one();
+	}
+
+
+	bool thread_pool::run_one(){
+		std::function< void() > task;
+		if(!pop(is_worker() ? current_index : workers_.size(), task)){
+			return false;
+		}
+
+		task();
+		return true;
+	}
+
+
+	void thread_pool::run_until(std::function< bool() > const& done){
+		auto const index = is_worker() ? current_index : workers_.size();
+
+		std::function< void() > task;
+		for(;;){
+			if(done()) return;
+
+			if(pop(index, task)){
+				task();
+				task = nullptr;
+				continue;
+			}
+
+			// wake_helpers() is called after done() became true, it loads
+			// helping_ after we incremented it or we see done()
+			bool finished = false;
+			std::unique_lock< std::mutex > lock(sleep_mutex_);
+			sleeping_.fetch_add(1);
+			helping_.fetch_add(1);
+			sleep_cv_.wait(lock, [this, &done, &finished]{
+				return pending_.load() > 0 || (finished = done());
+			});
+			helping_.fetch_sub(1, std::memory_order_relaxed);
+			sleeping_.fetch_sub(1, std::memory_order_relaxed);
+
+			if(finished) return;
+		}
+	}
+
+
+	void thread_pool::wake_helpers(){
+		if(helping_.load() == 0) return;
+
+		std::lock_guard< std::mutex > lock(sleep_mutex_);
+		sleep_cv_.notify_all();
+	}
+
+
+	bool thread_pool::pop(std::size_t index, std::function< void() >& task){
+		if(pending_.load(std::memory_order_relaxed) == 0) return false;
+
+		auto take = [this, &task](task_queue& queue, bool back){
+			std::lock_guard< std::mutex > lock(queue.mutex);
+			if(queue.tasks.empty()) return false;
+
+			if(back){
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}else{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+
+			pending_.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		};
+
+		// newest task of the own deque
+		if(index < workers_.size() && take(*workers_[index], true)){
+			return true;
+		}
+
+		// oldest task of the injection queue
+		if(take(injected_, false)) return true;
+
+		// steal the oldest task of another worker
+		for(std::size_t i = 1; i <= workers_.size(); ++i){
+			auto const victim = (index + i) % workers_.size();
+			if(victim != index && take(*workers_[victim], false)){
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+	void thread_pool::work(std::size_t index)noexcept{
+		current_pool = this;
+		current_index = index;
+
+		std::function< void() > task;
+		for(;;){
+			if(pop(index, task)){
+				task();
+				task = nullptr;
+				continue;
+			}
+
+			std::unique_lock< std::mutex > lock(sleep_mutex_);
+			sleeping_.fetch_add(1);
+			sleep_cv_.wait(lock, [this]{
+				return shutdown_ || pending_.load() > 0;
+			});
+			sleeping_.fetch_sub(1, std::memory_order_relaxed);
+
+			// the destructor waits until all tasks are done
+			if(shutdown_ && pending_.load() == 0) return;
+		}
+	}
+
+
+}
@@ -0,0 +1,1212 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/module.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+
+using disposer::make_data;
+using disposer::module_ptr;
+
+
+/// \brief Log that swallows all messages
+struct silent_log: disposer::log_base{
+	std::ostream& os()override{ return os_; }
+	std::ostringstream os_;
+};
+
+
+/// \brief Puts the id, counts the exec calls
+struct source: disposer::module_base{
+	source(make_data const& data):
+		disposer::module_base(data, {out}) {}
+
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		++execs;
+		out.put(id);
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+
+	static std::atomic< std::size_t > execs;
+};
+
+std::atomic< std::size_t > source::execs{0};
+
+/// \brief Puts input + 1, throws on input 2, 6, 10, ...
+struct add: disposer::module_base{
+	add(make_data const& data):
+		disposer::module_base(data, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		auto value = in.get_one().get();
+		if(value->data() % 4 == 2) throw std::runtime_error("add");
+		out.put(value->data() + 1);
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+};
+
+/// \brief Collects all inputs
+struct sink: disposer::module_base{
+	sink(make_data const& data):
+		disposer::module_base(data, {in}) {}
+
+	disposer::input< std::size_t > in{"in"};
+
+	void exec()override{
+		for(auto& [id, data]: in.get()){
+			(void)id;
+			auto value = data.get_shared();
+			std::lock_guard< std::mutex > lock(mutex);
+			values.push_back(*value);
+		}
+	}
+
+	static std::mutex mutex;
+	static std::vector< std::size_t > values;
+};
+
+std::mutex sink::mutex;
+std::vector< std::size_t > sink::values;
+
+
+/// \brief Collects the inputs of ids 0, 4, 8, ...
+struct sample: sink{
+	sample(make_data const& data):
+		sink(data)
+	{
+		in.set_demand([](std::size_t id){ return id % 4 == 0; });
+	}
+};
+
+
+/// \brief Collects all inputs, the demand of id refused throws
+struct picky: sink{
+	picky(make_data const& data):
+		sink(data)
+	{
+		in.set_demand([](std::size_t id){
+			if(id == refused) throw std::runtime_error("picky");
+			return true;
+		});
+	}
+
+	static std::atomic< std::size_t > refused;
+};
+
+std::atomic< std::size_t > picky::refused{0};
+
+
+/// \brief Aborts the runs 0, 3, 6, ..., skips the rest of the runs 1, 4,
+///        7, ... and puts the input in all other runs
+struct drop: disposer::module_base{
+	drop(make_data const& data):
+		disposer::module_base(data, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		auto const value = in.get_one().data();
+		if(value % 3 == 0){
+			abort_run();
+		}else if(value % 3 == 1){
+			skip_rest();
+		}else{
+			out.put(value);
+		}
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+};
+
+
+/// \brief Puts the id as soon as released is true
+struct hold: disposer::module_base{
+	hold(make_data const& data):
+		disposer::module_base(data, {out}) {}
+
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		++entered;
+		while(!released) std::this_thread::yield();
+		out.put(id);
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+
+	static std::atomic< std::size_t > entered;
+	static std::atomic< bool > released;
+};
+
+std::atomic< std::size_t > hold::entered{0};
+std::atomic< bool > hold::released{false};
+
+
+/// \brief Puts the input, holds the input held until trace got the input
+///        of the next run, 0 holds nothing
+struct lag: disposer::module_base{
+	lag(make_data const& data):
+		disposer::module_base(data, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		auto const value = in.get_one().data();
+		if(value == held) overtaken.get_future().wait();
+		out.put(value);
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+
+	static std::atomic< std::size_t > held;
+	static std::promise< void > overtaken;
+};
+
+std::atomic< std::size_t > lag::held{0};
+std::promise< void > lag::overtaken;
+
+
+/// \brief Puts the input, records the order of the inputs
+struct trace: disposer::module_base{
+	trace(make_data const& data):
+		disposer::module_base(data, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		auto const value = in.get_one().data();
+		{
+			std::lock_guard< std::mutex > lock(mutex);
+			values.push_back(value);
+		}
+		if(lag::held != 0 && value == lag::held + 1){
+			lag::overtaken.set_value();
+		}
+		out.put(value);
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+
+	static std::mutex mutex;
+	static std::vector< std::size_t > values;
+};
+
+std::mutex trace::mutex;
+std::vector< std::size_t > trace::values;
+
+
+/// \brief Puts input, input + 1, input + 2 and input + 3 with 4 ids
+struct split: disposer::module_base{
+	split(make_data const& data):
+		disposer::module_base(data, 4, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		for(auto& [id, data]: in.get()){
+			(void)id;
+			auto const value = data.data();
+			out.put_range(this->id,
+				std::vector< std::size_t >{
+					value, value + 1, value + 2, value + 3});
+		}
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+};
+
+
+/// \brief Puts the id as number and as text
+struct tag: disposer::module_base{
+	tag(make_data const& data):
+		disposer::module_base(data, {out}) {}
+
+	disposer::output< std::size_t, std::string > out{"out"};
+
+	void exec()override{
+		out.put< std::size_t >(id);
+		out.put< std::string >(std::to_string(id));
+	}
+
+	void input_ready()override{ out.enable< std::size_t, std::string >(); }
+};
+
+/// \brief Collects numbers and 1000 + text per type
+struct collect: disposer::module_base{
+	collect(make_data const& data):
+		disposer::module_base(data, {in}) {}
+
+	disposer::input< std::size_t, std::string > in{"in"};
+
+	void exec()override{
+		std::lock_guard< std::mutex > lock(sink::mutex);
+		for(auto& [id, data]: in.get< std::size_t >()){
+			(void)id;
+			sink::values.push_back(data.data());
+		}
+		in.for_each< std::string >([](std::size_t, auto const& data){
+			sink::values.push_back(1000 + std::stoul(data.data()));
+		});
+	}
+};
+
+
+/// \brief Gets and puts the data in a thread that exec() starts
+struct helper: disposer::module_base{
+	helper(make_data const& data):
+		disposer::module_base(data, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		std::thread([this]{
+			auto const value = in.get_one().data();
+			std::size_t const current = id;
+			if(value != current) throw std::logic_error("helper");
+			out.put(value);
+		}).join();
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+};
+
+
+/// \brief Puts the input, passes 1024 copies of it in the run memory via
+///        the scratch storage to a thread
+struct stash: disposer::module_base{
+	stash(make_data const& data):
+		disposer::module_base(data, {in}, {out}) {}
+
+	disposer::input< std::size_t > in{"in"};
+	disposer::output< std::size_t > out{"out"};
+
+	void exec()override{
+		// the scratch storage of the previous run is gone
+		if(scratch().has_value()) throw std::logic_error("stash");
+
+		// more than the 512 bytes in the context
+		auto const value = in.get_one().data();
+		std::pmr::vector< std::size_t > values(1024, value, &run_memory());
+		scratch() = values.data();
+
+		std::thread([this]{
+			auto const data = std::any_cast< std::size_t* >(scratch());
+			if(std::count(data, data + 1024, data[0]) != 1024){
+				throw std::logic_error("stash");
+			}
+			out.put(data[0]);
+		}).join();
+	}
+
+	void input_ready()override{ out.enable< std::size_t >(); }
+};
+
+
+/// \brief Calls exec() of its chain and counts the rejections
+struct reenter: disposer::module_base{
+	reenter(make_data const& data):
+		disposer::module_base(data, {in}) {}
+
+	disposer::input< std::size_t > in{"in"};
+
+	void exec()override{
+		try{ target->exec(); }catch(std::logic_error const&){ ++rejected; }
+	}
+
+	static disposer::chain* target;
+	static std::atomic< std::size_t > rejected;
+};
+
+disposer::chain* reenter::target = nullptr;
+std::atomic< std::size_t > reenter::rejected(0);
+
+
+/// \brief Counts the allocations, the memory is from new and delete
+struct counting_resource: std::pmr::memory_resource{
+	std::atomic< std::size_t > allocations{0};
+
+	void* do_allocate(std::size_t bytes, std::size_t align)override{
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, align);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t align)override{
+		std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+	}
+
+	bool do_is_equal(
+		std::pmr::memory_resource const& other
+	)const noexcept override{
+		return this == &other;
+	}
+};
+
+
+char const* const config =
+R"file(parameter_set
+	unused
+		unused = 0
+module
+	source = source
+	add = add
+	add2 = add
+	sink = sink
+	sink2 = sink
+	split = split
+	tag = tag
+	collect = collect
+	sample = sample
+	drop = drop
+	hold = hold
+	lag = lag
+	trace = trace
+	picky = picky
+	helper = helper
+	stash = stash
+	reenter = reenter
+chain
+	chain
+		id_generator = chain
+		source
+			->
+				out = v1
+		add
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			<-
+				in = v2
+	fan_out
+		id_generator = fan_out
+		source
+			->
+				out = v1
+		add
+			<-
+				in = v1
+			->
+				out = v2
+		add2
+			<-
+				in = v1
+			->
+				out = v3
+		sink
+			<-
+				in = v2
+		sink2
+			<-
+				in = v3
+	replicated
+		id_generator = replicated
+		source
+			->
+				out = v1
+		add
+			replicas = 3
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			<-
+				in = v2
+	counted
+		id_generator = counted
+		memory_resource = chain
+		tag
+			memory_resource = module
+			->
+				out = v1
+		collect
+			<-
+				in = v1
+	splitted
+		id_generator = splitted
+		source
+			->
+				out = v1
+		split
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			<-
+				in = v2
+	mixed
+		id_generator = mixed
+		tag
+			->
+				out = v1
+		collect
+			<-
+				in = v1
+	demanded
+		id_generator = demanded
+		source
+			->
+				out = v1
+		add
+			<-
+				in = v1
+			->
+				out = v2
+		sample
+			<-
+				in = v2
+	dropped
+		id_generator = dropped
+		source
+			->
+				out = v1
+		drop
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			<-
+				in = v2
+		sink2
+			<-
+				in = v1
+	limited
+		id_generator = limited
+		max_in_flight = 1
+		overload_policy = fail
+		hold
+			->
+				out = v1
+		sink
+			<-
+				in = v1
+	relaxed
+		id_generator = relaxed
+		run_order = relaxed
+		source
+			->
+				out = v1
+		lag
+			replicas = 2
+			<-
+				in = v1
+			->
+				out = v2
+		trace
+			<-
+				in = v2
+			->
+				out = v3
+		sink
+			<-
+				in = v3
+	staged
+		id_generator = staged
+		source
+			stage = input
+			cpus = $cpu
+			->
+				out = v1
+		trace
+			stage = work
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			cpus = $cpu
+			<-
+				in = v2
+	picky
+		id_generator = picky
+		source
+			->
+				out = v1
+		picky
+			<-
+				in = v1
+	helped
+		id_generator = helped
+		source
+			->
+				out = v1
+		helper
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			<-
+				in = v2
+	stashed
+		id_generator = stashed
+		source
+			->
+				out = v1
+		stash
+			<-
+				in = v1
+			->
+				out = v2
+		sink
+			<-
+				in = v2
+	reentrant
+		id_generator = reentrant
+		source
+			->
+				out = v1
+		reenter
+			stage = loop
+			<-
+				in = v1
+)file";
+
+
+/// \brief A CPU the calling thread may run on
+std::size_t allowed_cpu(){
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if(sched_getaffinity(0, sizeof(set), &set) == 0){
+		for(std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu){
+			if(CPU_ISSET(cpu, &set)) return cpu;
+		}
+	}
+#endif
+	// CPU affinity is ignored
+	return 0;
+}
+
+/// \brief The config with the staged modules pinned to cpu
+std::string make_config(std::size_t cpu){
+	std::string result = config;
+	std::string const placeholder = "$cpu";
+	for(
+		auto pos = result.find(placeholder);
+		pos != std::string::npos;
+		pos = result.find(placeholder, pos)
+	){
+		result.replace(pos, placeholder.size(), std::to_string(cpu));
+	}
+	return result;
+}
+
+
+int success(std::string const& msg){
+	std::cout << "\033[0;32msuccess:\033[0m " << msg << "\n";
+	return 0;
+}
+
+int fail(std::string const& msg){
+	std::cout << "\033[0;31mfail:\033[0m " << msg << "\n";
+	return 1;
+}
+
+int check(
+	std::string const& name,
+	std::vector< std::size_t > const& expected
+){
+	if(sink::values == expected) return success(name);
+
+	std::ostringstream os;
+	os << name << ":";
+	for(auto v: sink::values) os << ' ' << v;
+	return fail(os.str());
+}
+
+
+/// \brief Connect out to in without chain
+void connect(
+	disposer::output< std::size_t >& out,
+	disposer::input< std::size_t >& in
+){
+	using boost::typeindex::type_id_with_cvr;
+
+	out.enable< std::size_t >();
+	static_cast< disposer::input_base& >(in).enable_types(
+		disposer::make_creator_key(), {type_id_with_cvr< std::size_t >()});
+	out.get_signal(disposer::make_creator_key())
+		.connect({type_id_with_cvr< std::size_t >()}, {in}, true);
+}
+
+
+int main(){
+	disposer::log_base::factory = []{
+		return std::make_unique< silent_log >();
+	};
+
+	std::size_t r = 0;
+
+	// copy on write, get() copies only while another input holds the data,
+	// even if it is the last use
+	{
+		using data_type = std::vector< std::size_t >;
+		auto data = std::make_shared< disposer::output_data< data_type > >(
+			data_type{7});
+		auto const address = &data->data();
+		disposer::input_data< data_type > first(data, false);
+		disposer::input_data< data_type > second(data, true);
+		data.reset();
+
+		auto shared = first.get_shared();
+		bool const copied = &second.get()->data() != address;
+		first = disposer::input_data< data_type >(nullptr, false);
+		shared.reset();
+		bool const moved = &second.get()->data() == address;
+
+		r += copied && moved
+			? success("copy on write")
+			: fail("copy on write");
+	}
+
+	// put_range() must stay in the ids of the run
+	{
+		disposer::output< std::size_t > out{"out"};
+		out.enable< std::size_t >();
+
+		disposer::exec_context context(8, 0, 1);
+		disposer::exec_context_scope scope(context);
+
+		bool rejected = false;
+		try{
+			out.put_range(9, std::vector< std::size_t >{1});
+		}catch(std::logic_error const&){
+			rejected = true;
+		}
+
+		r += rejected
+			? success("put_range outside")
+			: fail("put_range outside");
+	}
+
+	// put_range() reads a single pass range once
+	{
+		disposer::output< std::size_t > out{"out"};
+		disposer::input< std::size_t > in{"in"};
+		out.set_id_increase(disposer::make_creator_key(), 2);
+		connect(out, in);
+
+		disposer::exec_context context(8, 0, 1);
+		disposer::exec_context_scope scope(context);
+
+		struct{
+			std::istringstream stream{"3 4"};
+
+			auto begin(){
+				return std::istream_iterator< std::size_t >(stream);
+			}
+
+			auto end(){ return std::istream_iterator< std::size_t >(); }
+		} values;
+		out.put_range(8, values);
+
+		std::vector< std::pair< std::size_t, std::size_t > > got;
+		for(auto& [id, data]: in.get()) got.emplace_back(id, data.data());
+
+		r += got == decltype(got){{8, 3}, {9, 4}}
+			? success("put_range single pass")
+			: fail("put_range single pass");
+	}
+
+	// get_one() gets the data of previous runs like get(), so it throws
+	// with the data of two runs
+	{
+		disposer::output< std::size_t > out{"out"};
+		disposer::input< std::size_t > in{"in"};
+		in.set_single_value(disposer::make_creator_key(), true);
+		connect(out, in);
+
+		{
+			disposer::exec_context context(0, 0, 1);
+			disposer::exec_context_scope scope(context);
+			out.put(std::size_t(1));
+		}
+
+		disposer::exec_context context(1, 1, 1);
+		disposer::exec_context_scope scope(context);
+		out.put(std::size_t(2));
+
+		bool thrown = false;
+		try{ in.get_one(); }catch(std::logic_error const&){ thrown = true; }
+
+		r += thrown && in.get().empty()
+			? success("get_one previous runs")
+			: fail("get_one previous runs");
+	}
+
+	auto const cpu = allowed_cpu();
+	std::string const filename = "chain_exec.ini";
+	std::ofstream(filename) << make_config(cpu);
+
+	counting_resource chain_resource;
+	counting_resource module_resource;
+
+	disposer::disposer disposer(2);
+	disposer.add_memory_resource("chain", chain_resource);
+	disposer.add_memory_resource("module", module_resource);
+	disposer.declarant()("source", [](make_data& data)->module_ptr{
+		return std::make_unique< source >(data); });
+	disposer.declarant()("add", [](make_data& data)->module_ptr{
+		return std::make_unique< add >(data); });
+	disposer.declarant()("sink", [](make_data& data)->module_ptr{
+		return std::make_unique< sink >(data); });
+	disposer.declarant()("split", [](make_data& data)->module_ptr{
+		return std::make_unique< split >(data); });
+	disposer.declarant()("tag", [](make_data& data)->module_ptr{
+		return std::make_unique< tag >(data); });
+	disposer.declarant()("collect", [](make_data& data)->module_ptr{
+		return std::make_unique< collect >(data); });
+	disposer.declarant()("sample", [](make_data& data)->module_ptr{
+		return std::make_unique< sample >(data); });
+	disposer.declarant()("drop", [](make_data& data)->module_ptr{
+		return std::make_unique< drop >(data); });
+	disposer.declarant()("hold", [](make_data& data)->module_ptr{
+		return std::make_unique< hold >(data); });
+	disposer.declarant()("lag", [](make_data& data)->module_ptr{
+		return std::make_unique< lag >(data); });
+	disposer.declarant()("trace", [](make_data& data)->module_ptr{
+		return std::make_unique< trace >(data); });
+	disposer.declarant()("picky", [](make_data& data)->module_ptr{
+		return std::make_unique< picky >(data); });
+	disposer.declarant()("helper", [](make_data& data)->module_ptr{
+		return std::make_unique< helper >(data); });
+	disposer.declarant()("stash", [](make_data& data)->module_ptr{
+		return std::make_unique< stash >(data); });
+	disposer.declarant()("reenter", [](make_data& data)->module_ptr{
+		return std::make_unique< reenter >(data); });
+	disposer.load(filename);
+
+	auto& chain = disposer.get_chain("chain");
+
+	// a disabled chain rejects the run without using an id
+	bool rejected = false;
+	try{ chain.exec(); }catch(std::logic_error const&){ rejected = true; }
+	r += rejected ? success("exec disabled") : fail("exec disabled");
+
+	chain.enable();
+
+	// synchronous, id 2 fails in add
+	for(std::size_t i = 0; i < 4; ++i){
+		try{ chain.exec(); }catch(std::runtime_error const&){}
+	}
+	r += check("exec", {1, 2, 4});
+
+	// asynchronous, id 6, 10, 14 and 18 fail in add
+	sink::values.clear();
+	std::vector< std::future< bool > > futures;
+	for(std::size_t i = 0; i < 16; ++i){
+		futures.push_back(chain.exec_async());
+	}
+
+	std::size_t exceptions = 0;
+	for(auto& future: futures){
+		try{ future.get(); }catch(std::runtime_error const&){ ++exceptions; }
+	}
+	r += check("exec_async", {5, 6, 8, 9, 10, 12, 13, 14, 16, 17, 18, 20});
+	r += exceptions == 4
+		? success("exec_async exception")
+		: fail("exec_async exception");
+
+	// synchronous from 8 threads, ids 22, 26, ..., 50 fail in add
+	sink::values.clear();
+	std::vector< std::thread > threads;
+	for(std::size_t i = 0; i < 8; ++i){
+		threads.emplace_back([&chain]{
+			for(std::size_t i = 0; i < 4; ++i){
+				try{ chain.exec(); }catch(std::runtime_error const&){}
+			}
+		});
+	}
+	for(auto& thread: threads) thread.join();
+
+	std::sort(sink::values.begin(), sink::values.end());
+	std::vector< std::size_t > expected;
+	for(std::size_t i = 21; i <= 52; ++i){
+		if(i % 4 != 3) expected.push_back(i);
+	}
+	r += check("exec from threads", expected);
+
+	chain.disable();
+
+	// independent branches, ids 2 and 6 fail in add and add2
+	auto& fan_out = disposer.get_chain("fan_out");
+	fan_out.enable();
+
+	sink::values.clear();
+	futures.clear();
+	for(std::size_t i = 0; i < 8; ++i){
+		futures.push_back(fan_out.exec_async());
+	}
+
+	exceptions = 0;
+	for(auto& future: futures){
+		try{ future.get(); }catch(std::runtime_error const&){ ++exceptions; }
+	}
+
+	std::sort(sink::values.begin(), sink::values.end());
+	r += check("fan_out", {1, 1, 2, 2, 4, 4, 5, 5, 6, 6, 8, 8});
+	r += exceptions == 2
+		? success("fan_out exception")
+		: fail("fan_out exception");
+
+	fan_out.disable();
+
+	// add has 3 replicas, sink still gets the data in run order, ids 2, 6
+	// and 10 fail in add
+	auto& replicated = disposer.get_chain("replicated");
+	replicated.enable();
+
+	sink::values.clear();
+	futures.clear();
+	for(std::size_t i = 0; i < 12; ++i){
+		futures.push_back(replicated.exec_async());
+	}
+
+	exceptions = 0;
+	for(auto& future: futures){
+		try{ future.get(); }catch(std::runtime_error const&){ ++exceptions; }
+	}
+
+	r += check("replicated", {1, 2, 4, 5, 6, 8, 9, 10, 12});
+	r += exceptions == 3
+		? success("replicated exception")
+		: fail("replicated exception");
+
+	replicated.disable();
+
+	// the chain and tag allocate from their configured resources
+	auto& counted = disposer.get_chain("counted");
+	counted.enable();
+
+	sink::values.clear();
+	auto const chain_allocations = chain_resource.allocations.load();
+	auto const module_allocations = module_resource.allocations.load();
+	for(std::size_t i = 0; i < 4; ++i) counted.exec();
+
+	r += check("memory resource",
+		{0, 1000, 1, 1001, 2, 1002, 3, 1003});
+	r += chain_resource.allocations > chain_allocations
+		&& module_resource.allocations > module_allocations
+		? success("memory resource allocations")
+		: fail("memory resource allocations");
+
+	counted.disable();
+
+	// split puts 4 ids per run with one put_range call, the runs get the
+	// ids 0 and 4
+	auto& splitted = disposer.get_chain("splitted");
+	splitted.enable();
+
+	sink::values.clear();
+	for(std::size_t i = 0; i < 2; ++i) splitted.exec();
+
+	r += check("put_range", {0, 1, 2, 3, 4, 5, 6, 7});
+
+	splitted.disable();
+
+	// collect gets the data of its two input types separately
+	auto& mixed = disposer.get_chain("mixed");
+	mixed.enable();
+
+	sink::values.clear();
+	for(std::size_t i = 0; i < 2; ++i) mixed.exec();
+
+	r += check("typed get", {0, 1000, 1, 1001});
+
+	// std::string is shared via output_data_ptr, the second run reuses the
+	// memory of the first one
+	auto const& pools = mixed.pools().pools();
+	auto const pool = pools.find({
+			boost::typeindex::type_id_with_cvr< std::string >(),
+			std::pmr::get_default_resource()
+		});
+	r += pool != pools.end() && pool->second->hits() > 0
+		? success("data pool")
+		: fail("data pool");
+
+	mixed.disable();
+
+	// sample needs only id 0, source and add are skipped in the other
+	// runs, so id 2 does not fail in add
+	auto& demanded = disposer.get_chain("demanded");
+	demanded.set_demand_driven(true);
+	demanded.enable();
+
+	sink::values.clear();
+	auto const source_execs = source::execs.load();
+	for(std::size_t i = 0; i < 4; ++i) demanded.exec();
+
+	r += check("demand driven", {1});
+	r += source::execs - source_execs == 1
+		? success("demand driven skip")
+		: fail("demand driven skip");
+
+	demanded.disable();
+
+	// drop aborts the ids 0 and 3 without exception, sink2 gets no data
+	// then, it skips sink for the ids 1 and 4
+	auto& dropped = disposer.get_chain("dropped");
+	dropped.enable();
+
+	sink::values.clear();
+	exceptions = 0;
+	std::vector< bool > completed;
+	for(std::size_t i = 0; i < 6; ++i){
+		try{
+			completed.push_back(dropped.exec());
+		}catch(...){
+			++exceptions;
+		}
+	}
+
+	std::sort(sink::values.begin(), sink::values.end());
+	r += check("abort and skip", {1, 2, 2, 4, 5, 5});
+	r += exceptions == 0 && completed
+		== std::vector< bool >{false, true, true, false, true, true}
+		? success("abort without exception")
+		: fail("abort without exception");
+
+	dropped.disable();
+
+	// the config allows one run in progress, the second run is rejected
+	// without id while the first one holds
+	auto& limited = disposer.get_chain("limited");
+	limited.enable();
+
+	auto const wait_entered = [](std::size_t count){
+		while(hold::entered < count) std::this_thread::yield();
+	};
+
+	sink::values.clear();
+	futures.clear();
+	futures.push_back(limited.exec_async());
+	wait_entered(1);
+	futures.push_back(limited.exec_async());
+	hold::released = true;
+
+	r += futures[0].get() && !futures[1].get()
+		&& limited.rejected_runs() == 1
+		? success("max_in_flight fail")
+		: fail("max_in_flight fail");
+
+	// with two runs in progress, the third run drops the second one,
+	// which did not start because the first one holds
+	hold::released = false;
+	limited.set_max_in_flight(2, disposer::overload_policy::drop_oldest);
+
+	futures.clear();
+	futures.push_back(limited.exec_async());
+	wait_entered(2);
+	futures.push_back(limited.exec_async());
+	futures.push_back(limited.exec_async());
+	hold::released = true;
+
+	bool const results[] = {
+		futures[0].get(), futures[1].get(), futures[2].get()};
+	r += results[0] && !results[1] && results[2]
+		&& limited.dropped_runs() == 1
+		? success("max_in_flight drop_oldest")
+		: fail("max_in_flight drop_oldest");
+	r += check("max_in_flight", {0, 1, 3});
+
+	// latest wins, the runs 5 and 6 wait behind 4 and are replaced by the
+	// newer runs
+	hold::released = false;
+	limited.set_max_in_flight(0);
+	limited.set_latest_wins(true);
+
+	sink::values.clear();
+	futures.clear();
+	futures.push_back(limited.exec_async());
+	wait_entered(4);
+	for(std::size_t i = 0; i < 3; ++i){
+		futures.push_back(limited.exec_async());
+	}
+	hold::released = true;
+
+	std::vector< bool > latest;
+	for(auto& future: futures) latest.push_back(future.get());
+	r += latest == std::vector< bool >{true, false, false, true}
+		&& limited.coalesced_runs() == 2
+		? success("latest wins")
+		: fail("latest wins");
+	r += check("latest wins values", {4, 7});
+
+	limited.disable();
+
+	// relaxed run order, lag holds id 1 until 2 overtook it in trace, sink
+	// still gets the data in run order
+	auto& relaxed = disposer.get_chain("relaxed");
+	relaxed.enable();
+
+	lag::held = 1;
+	sink::values.clear();
+	futures.clear();
+	for(std::size_t i = 0; i < 4; ++i){
+		futures.push_back(relaxed.exec_async());
+	}
+	for(auto& future: futures) future.get();
+
+	auto const position = [](std::size_t value){
+		return std::find(trace::values.begin(), trace::values.end(), value)
+			- trace::values.begin();
+	};
+	r += relaxed.is_relaxed_order() && position(2) < position(1)
+		? success("relaxed overtake")
+		: fail("relaxed overtake");
+	r += check("relaxed order", {0, 1, 2, 3});
+
+	lag::held = 0;
+	relaxed.disable();
+
+	// every module runs on the dedicated thread of its stage, sink gets a
+	// stage of its own
+	auto& staged = disposer.get_chain("staged");
+	staged.enable();
+
+	sink::values.clear();
+	for(std::size_t i = 0; i < 4; ++i) staged.exec();
+
+	bool stages_ok = staged.stage_count() == 3;
+	for(std::size_t i = 0; stages_ok && i < 3; ++i){
+		stages_ok = staged.stage(i).tasks() == 4;
+	}
+	r += stages_ok
+		&& staged.stage(0).cpus() == std::vector< std::size_t >{cpu}
+		&& staged.stage(1).cpus().empty()
+		&& staged.stage(2).name == "sink"
+		? success("stages")
+		: fail("stages");
+	r += check("stages values", {0, 1, 2, 3});
+
+	staged.disable();
+
+	// the demand of id 1 throws before the run starts, the later runs
+	// must not wait for it
+	auto& refusing = disposer.get_chain("picky");
+	refusing.set_demand_driven(true);
+	refusing.enable();
+
+	picky::refused = 1;
+	sink::values.clear();
+	exceptions = 0;
+	for(std::size_t i = 0; i < 3; ++i){
+		try{ refusing.exec(); }catch(std::runtime_error const&){ ++exceptions; }
+	}
+
+	r += exceptions == 1
+		? success("demand exception")
+		: fail("demand exception");
+	r += check("demand exception values", {0, 2});
+
+	refusing.disable();
+
+	// helper uses its input, its output and the id in a thread of its own
+	auto& helped = disposer.get_chain("helped");
+	helped.enable();
+
+	sink::values.clear();
+	for(std::size_t i = 0; i < 3; ++i) helped.exec();
+
+	r += check("helper thread", {0, 1, 2});
+
+	helped.disable();
+
+	// stash uses run memory and scratch storage, both are new in every run
+	auto& stashed = disposer.get_chain("stashed");
+	stashed.enable();
+
+	sink::values.clear();
+	for(std::size_t i = 0; i < 3; ++i) stashed.exec();
+
+	r += check("run memory and scratch", {0, 1, 2});
+
+	stashed.disable();
+
+	// exec() in a stage thread of the chain would wait for the stage
+	auto& reentrant = disposer.get_chain("reentrant");
+	reenter::target = &reentrant;
+	reentrant.enable();
+
+	auto const reentered = reentrant.exec() && reentrant.exec();
+	r += reentered && reenter::rejected == 2
+		? success("exec in stage thread")
+		: fail("exec in stage thread");
+
+	reentrant.disable();
+
+	// a higher limit admits a blocked run while the first one holds
+	hold::released = false;
+	limited.set_latest_wins(false);
+	limited.set_max_in_flight(1);
+	limited.enable();
+
+	auto const entered = hold::entered.load();
+	sink::values.clear();
+	auto first = limited.exec_async();
+	wait_entered(entered + 1);
+
+	std::promise< void > started;
+	std::future< bool > second;
+	std::thread blocked([&]{
+		started.set_value();
+		second = limited.exec_async();
+	});
+	started.get_future().wait();
+
+	// give the thread time to block, the check passes without it too
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	limited.set_max_in_flight(2);
+	blocked.join();
+	hold::released = true;
+
+	r += first.get() && second.get()
+		? success("max_in_flight raised")
+		: fail("max_in_flight raised");
+
+	limited.disable();
+
+	if(r == 0){
+		std::cout << "\033[0;32mSUCCESS\033[0m\n";
+	}else{
+		std::cout << "\033[0;31mFAILS:\033[0m " << r << '\n';
+	}
+
+	return r != 0;
+}
@@ -0,0 +1,164 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/data_pool.hpp>
+#include <disposer/output_data.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <array>
+#include <vector>
+#include <mutex>
+
+
+using array = std::array< double, 8 >;
+using data = disposer::output_data< array >;
+
+
+// The old data_pool: one mutex per pool protects the free list
+class locked_pool{
+public:
+	~locked_pool(){
+		for(auto block: free_){
+			::operator delete(block);
+		}
+	}
+
+	void* allocate(std::size_t size){
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			if(block_size_ == 0) block_size_ = size;
+
+			if(size == block_size_ && !free_.empty()){
+				auto block = free_.back();
+				free_.pop_back();
+				return block;
+			}
+		}
+
+		return ::operator new(size);
+	}
+
+	void deallocate(void* block, std::size_t size)noexcept{
+		{
+			std::lock_guard< std::mutex > lock(mutex_);
+			if(size == block_size_ && free_.size() < 64){
+				free_.push_back(block);
+				return;
+			}
+		}
+
+		::operator delete(block);
+	}
+
+private:
+	std::mutex mutex_;
+	std::size_t block_size_ = 0;
+	std::vector< void* > free_;
+};
+
+template < typename T >
+class locked_allocator{
+public:
+	using value_type = T;
+
+	explicit locked_allocator(locked_pool& pool)noexcept: pool_(&pool) {}
+
+	template < typename U >
+	locked_allocator(locked_allocator< U > const& other)noexcept:
+		pool_(&other.pool()) {}
+
+	T* allocate(std::size_t n){
+		return static_cast< T* >(pool_->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n)noexcept{
+		pool_->deallocate(p, n * sizeof(T));
+	}
+
+	locked_pool& pool()const noexcept{ return *pool_; }
+
+private:
+	locked_pool* pool_;
+};
+
+template < typename T, typename U >
+bool operator==(
+	locked_allocator< T > const& l,
+	locked_allocator< U > const& r
+)noexcept{
+	return &l.pool() == &r.pool();
+}
+
+template < typename T, typename U >
+bool operator!=(
+	locked_allocator< T > const& l,
+	locked_allocator< U > const& r
+)noexcept{
+	return !(l == r);
+}
+
+
+// Every thread creates batches of 16 objects and releases them again, all
+// threads share one pool
+template < typename Make >
+void benchmark(
+	char const* name,
+	std::size_t thread_count,
+	std::size_t make_count,
+	Make const& make
+){
+	auto const start = std::chrono::steady_clock::now();
+
+	std::vector< std::thread > threads;
+	for(std::size_t t = 0; t < thread_count; ++t){
+		threads.emplace_back([&make, make_count]{
+			std::vector< std::shared_ptr< data > > batch;
+			batch.reserve(16);
+			for(std::size_t i = 0; i < make_count; i += 16){
+				for(std::size_t j = 0; j < 16; ++j) batch.push_back(make());
+				batch.clear();
+			}
+		});
+	}
+
+	for(auto& thread: threads) thread.join();
+
+	auto const time = std::chrono::duration< double, std::nano >(
+		std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::setw(11) << name
+		<< " threads " << std::setw(2) << thread_count
+		<< " time/make " << std::setw(8) << std::fixed
+		<< std::setprecision(2) << time / (make_count * thread_count)
+		<< " ns\n";
+}
+
+
+int main(){
+	std::size_t const make_count = 1000000;
+
+	for(std::size_t thread_count: {1, 2, 4, 8}){
+		benchmark("make_shared", thread_count, make_count, []{
+			return std::make_shared< data >(array{});
+		});
+
+		locked_pool locked;
+		benchmark("locked", thread_count, make_count, [&locked]{
+			return std::allocate_shared< data >(
+				locked_allocator< data >(locked), array{});
+		});
+
+		auto const pool = disposer::data_pool::make();
+		benchmark("data_pool", thread_count, make_count, [&pool]{
+			return disposer::make_pooled< data >(pool, array{});
+		});
+	}
+}
@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <boost/type_index.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <variant>
+#include <vector>
+#include <array>
+#include <map>
+
+
+using boost::typeindex::type_index;
+using boost::typeindex::type_id_with_cvr;
+
+
+// Both schemes store into the same sink, so only the dispatch differs
+template < typename ... T >
+struct sink{
+	static constexpr std::size_t type_count = sizeof...(T);
+
+	template < typename V >
+	void store(std::size_t id, void const* value){
+		data.emplace_back(id, *static_cast< V const* >(value));
+	}
+
+	std::vector< std::pair< std::size_t, std::variant< T ... > > > data;
+};
+
+
+// Copy of the old scheme: signal_t called the virtual input_base::add with
+// the type of the datum for every target, input::add looked the type up in
+// a std::map and called the typed member add through the found pointer
+struct lookup_input_base{
+	virtual void add(
+		std::size_t run,
+		std::size_t id,
+		void const* value,
+		type_index const& type,
+		bool last_use
+	) = 0;
+};
+
+template < typename ... T >
+struct lookup_input: lookup_input_base{
+	virtual void add(
+		std::size_t run,
+		std::size_t id,
+		void const* value,
+		type_index const& type,
+		bool last_use
+	)override{
+		auto iter = type_map_.find(type);
+		if(iter == type_map_.end()){
+			throw std::logic_error(
+				"unknown add type '" + type.pretty_name() + "'");
+		}
+
+		// Call add< type >(run, id, value, last_use)
+		(this->*(iter->second))(run, id, value, last_use);
+	}
+
+	template < typename V >
+	void add(std::size_t, std::size_t id, void const* value, bool){
+		target.template store< V >(id, value);
+	}
+
+	static std::map< type_index, void(lookup_input::*)(
+		std::size_t, std::size_t, void const*, bool
+	) > const type_map_;
+
+	sink< T ... > target;
+};
+
+template < typename ... T >
+std::map< type_index, void(lookup_input< T ... >::*)(
+	std::size_t, std::size_t, void const*, bool
+) > const lookup_input< T ... >::type_map_ = {
+		{ type_id_with_cvr< T >(), &lookup_input< T ... >::add< T > } ...
+	};
+
+template < typename ... T >
+struct lookup_signal{
+	template < typename V >
+	void put(std::size_t run, std::size_t id, V const& value){
+		for(auto& [inputs, last_use]: targets){
+			inputs[run % inputs.size()].get()
+				.add(run, id, &value, type_id_with_cvr< V >(), last_use);
+		}
+	}
+
+	void connect(lookup_input< T ... >& input, bool last_use){
+		targets.push_back({{input}, last_use});
+	}
+
+	std::vector< std::pair<
+		std::vector< std::reference_wrapper< lookup_input_base > >, bool
+	> > targets;
+};
+
+
+// Copy of the new scheme: connect resolved the entry point of the input
+// per output type, put passes the position of its type
+template < typename ... T >
+struct direct_input{
+	using add_function = void(*)(
+		direct_input& input,
+		std::size_t run,
+		std::size_t id,
+		void const* value
+	);
+
+	template < typename V, bool LastUse >
+	static void typed_add(
+		direct_input& input,
+		std::size_t,
+		std::size_t id,
+		void const* value
+	){
+		input.target.template store< V >(id, value);
+	}
+
+	sink< T ... > target;
+};
+
+template < typename V, typename T, typename ... U >
+constexpr std::size_t position(){
+	if constexpr(std::is_same_v< V, T >){
+		return 0;
+	}else{
+		return 1 + position< V, U ... >();
+	}
+}
+
+template < typename ... T >
+struct direct_signal{
+	using input_type = direct_input< T ... >;
+
+	struct delivery{
+		typename input_type::add_function add;
+		input_type* input;
+	};
+
+	template < typename V >
+	void put(std::size_t run, std::size_t id, V const& value){
+		for(auto& delivery: deliveries[position< V, T ... >()]){
+			delivery.add(*delivery.input, run, id, &value);
+		}
+	}
+
+	void connect(input_type& input, bool last_use){
+		std::size_t i = 0;
+		((deliveries[i++].push_back({last_use
+			? &input_type::template typed_add< T, true >
+			: &input_type::template typed_add< T, false >, &input})), ...);
+	}
+
+	std::array< std::vector< delivery >, sizeof...(T) > deliveries;
+};
+
+
+template < typename Signal, typename Input, typename V >
+void benchmark(char const* name, std::size_t put_count){
+	Input input;
+	Signal signal;
+	signal.connect(input, true);
+
+	auto const start = std::chrono::steady_clock::now();
+
+	std::size_t count = 0;
+	for(std::size_t i = 0; i < put_count; ++i){
+		signal.put(i, i, V(i));
+
+		// drain the input from time to time
+		if(i % 64 == 63){
+			count += input.target.data.size();
+			input.target.data.clear();
+		}
+	}
+
+	auto const time = std::chrono::duration< double, std::nano >(
+		std::chrono::steady_clock::now() - start).count();
+
+	if(count != put_count - put_count % 64){
+		throw std::logic_error("data lost");
+	}
+
+	std::cout << std::setw(8) << name
+		<< " input types " << decltype(input.target)::type_count
+		<< " time/put " << std::setw(8) << std::fixed
+		<< std::setprecision(2) << time / put_count << " ns\n";
+}
+
+
+int main(){
+	std::size_t const put_count = 1000000;
+
+	benchmark< lookup_signal< int >, lookup_input< int >, int >
+		("lookup", put_count);
+	benchmark< direct_signal< int >, direct_input< int >, int >
+		("direct", put_count);
+
+	benchmark< lookup_signal< char, short, int, long, double >,
+		lookup_input< char, short, int, long, double >, double >
+		("lookup", put_count);
+	benchmark< direct_signal< char, short, int, long, double >,
+		direct_input< char, short, int, long, double >, double >
+		("direct", put_count);
+}
@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/module.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <deque>
+
+
+using boost::typeindex::type_id_with_cvr;
+
+
+// Consume with get(), the general path
+struct get_all{
+	static constexpr char const* name = "get";
+
+	std::size_t operator()(disposer::input< int >& in)const{
+		std::size_t sum = 0;
+		for(auto& [id, data]: in.get()){
+			(void)id;
+			sum += data.data();
+		}
+		return sum;
+	}
+};
+
+// Consume with get_one(), the single value path
+struct get_one{
+	static constexpr char const* name = "get_one";
+
+	std::size_t operator()(disposer::input< int >& in)const{
+		return in.get_one().data();
+	}
+};
+
+
+// Put the data of overlap runs, then consume them in run order, only the
+// consumption is timed
+//
+// With sized, the ring of the input has a slot per overlapping run, like
+// in a chain with 'max_in_flight = overlap'. Otherwise it has the default
+// 8 slots and the runs beyond use the locked overflow list.
+template < typename Accessor >
+void benchmark(std::size_t overlap, std::size_t run_count, bool sized){
+	disposer::output< int > out{"out"};
+	disposer::input< int > in{"in"};
+
+	out.enable< int >();
+	static_cast< disposer::input_base& >(in).enable_types(
+		disposer::make_creator_key(), {type_id_with_cvr< int >()});
+	in.set_single_value(disposer::make_creator_key(), true);
+	if(sized) in.set_slot_count(disposer::make_creator_key(), overlap);
+	out.get_signal(disposer::make_creator_key())
+		.connect({type_id_with_cvr< int >()}, {in}, true);
+
+	Accessor accessor;
+	std::size_t sum = 0;
+	std::chrono::steady_clock::duration time{0};
+
+	for(std::size_t run = 0; run < run_count; run += overlap){
+		std::deque< disposer::exec_context > contexts;
+		for(std::size_t i = 0; i < overlap; ++i){
+			contexts.emplace_back(run + i, run + i, 1);
+		}
+
+		for(auto& context: contexts){
+			disposer::exec_context_scope scope(context);
+			out.put(static_cast< int >(context.id));
+		}
+
+		auto const start = std::chrono::steady_clock::now();
+		for(auto& context: contexts){
+			disposer::exec_context_scope scope(context);
+			sum += accessor(in);
+		}
+		time += std::chrono::steady_clock::now() - start;
+	}
+
+	auto const ns = std::chrono::duration< double, std::nano >(time).count();
+
+	std::cout << std::setw(8) << Accessor::name
+		<< " overlapping runs " << std::setw(2) << overlap
+		<< (sized ? " sized  " : " default")
+		<< " time/run " << std::setw(8) << std::fixed
+		<< std::setprecision(2) << ns / run_count << " ns"
+		<< " (" << sum << ")\n";
+}
+
+
+int main(){
+	std::size_t const run_count = 1 << 20;
+
+	for(std::size_t overlap: {1, 4, 16}){
+		benchmark< get_all >(overlap, run_count, false);
+		benchmark< get_one >(overlap, run_count, false);
+	}
+
+	// 16 runs overflow the default ring
+	benchmark< get_all >(16, run_count, true);
+	benchmark< get_one >(16, run_count, true);
+}
@@ -9,12 +9,11 @@
 #include <disposer/parse.hpp>
 #include <disposer/mask_non_print.hpp>
 
-#include <boost/optional/optional_io.hpp>
-
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <vector>
+#include <optional>
 
 namespace disposer{ namespace types{ namespace parse{
 
@@ -25,6 +24,12 @@ namespace disposer{ namespace types{ namespace parse{
 		return os;
 	}
 
+	template < typename T >
+	std::ostream& operator<<(std::ostream& os, std::optional< T > const& v){
+		if(v) return os << *v;
+		return os << "--";
+	}
+
 	template < typename T >
 	std::ostream& operator<<(std::ostream& os, std::vector< T > const& v){
 		os << '{';
@@ -55,12 +60,14 @@ namespace disposer{ namespace types{ namespace parse{
 
 	std::ostream& operator<<(std::ostream& os, chain_module const& v){
 		return os << "{" << v.name << "," << v.inputs << ","
-			<< v.outputs << "}";
+			<< v.outputs << "," << v.parameters << "}";
 	}
 
 	std::ostream& operator<<(std::ostream& os, chain const& v){
 		return os << "{" << v.name << "," << v.group << ","
-			<< v.id_generator << "," << v.modules << "}";
+			<< v.id_generator << "," << v.modules << ","
+			<< v.memory_resource << "," << v.max_in_flight << ","
+			<< v.overload_policy << "," << v.run_order << "}";
 	}
 
 	std::ostream& operator<<(std::ostream& os, config const& v){
@@ -108,7 +115,8 @@ namespace disposer{ namespace types{ namespace parse{
 	){
 		return l.name == r.name
 			&& l.inputs == r.inputs
-			&& l.outputs == r.outputs;
+			&& l.outputs == r.outputs
+			&& l.parameters == r.parameters;
 	}
 
 	bool operator==(
@@ -118,7 +126,11 @@ namespace disposer{ namespace types{ namespace parse{
 		return l.name == r.name
 			&& l.group == r.group
 			&& l.id_generator == r.id_generator
-			&& l.modules == r.modules;
+			&& l.modules == r.modules
+			&& l.memory_resource == r.memory_resource
+			&& l.max_in_flight == r.max_in_flight
+			&& l.overload_policy == r.overload_policy
+			&& l.run_order == r.run_order;
 	}
 
 	bool operator==(
@@ -204,10 +216,144 @@ chain
 							{},
 							{
 								{"out", "x1"}
+							},
+							{}
+						}
+					},
+					{},
+					{},
+					{},
+					{}
+				}
+			}
+		}
+	}
+	,
+	{
+R"file(parameter_set
+	ps1
+		param1 = v1
+module
+	mod1 = dmod1
+	mod2 = dmod2
+chain
+	chain1
+		memory_resource = arena
+		max_in_flight = 4
+		overload_policy = drop_oldest
+		run_order = relaxed
+		mod1
+			replicas = 2
+			memory_resource = pool
+			stage = input
+			cpus = 0,2-3
+			->
+				out = x1
+		mod2
+			ordered = true
+			<-
+				in = x1
+)file"
+	,
+		config{
+			{
+				{
+					"ps1",
+					{
+						{"param1", "v1"}
+					}
+				}
+			},
+			{
+				{"mod1", "dmod1", {}, {}},
+				{"mod2", "dmod2", {}, {}}
+			},
+			{
+				{
+					"chain1",
+					{},
+					{},
+					{
+						{
+							"mod1",
+							{},
+							{
+								{"out", "x1"}
+							},
+							{
+								{"replicas", "2"},
+								{"memory_resource", "pool"},
+								{"stage", "input"},
+								{"cpus", "0,2-3"}
+							}
+						},
+						{
+							"mod2",
+							{
+								{"in", "x1"}
+							},
+							{},
+							{
+								{"ordered", "true"}
 							}
 						}
+					},
+					{"arena"},
+					{"4"},
+					{"drop_oldest"},
+					{"relaxed"}
+				}
+			}
+		}
+	}
+	,
+	{
+R"file(parameter_set
+	ps1
+		param1 = v1
+module
+	mod1 = dmod1
+chain
+	chain1
+		max_in_flight = 1
+		run_order = strict
+		mod1
+			->
+				out = x1
+)file"
+	,
+		config{
+			{
+				{
+					"ps1",
+					{
+						{"param1", "v1"}
 					}
 				}
+			},
+			{
+				{"mod1", "dmod1", {}, {}}
+			},
+			{
+				{
+					"chain1",
+					{},
+					{},
+					{
+						{
+							"mod1",
+							{},
+							{
+								{"out", "x1"}
+							},
+							{}
+						}
+					},
+					{},
+					{"1"},
+					{},
+					{"strict"}
+				}
 			}
 		}
 	}
@@ -7,6 +7,7 @@
 // file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
 //-----------------------------------------------------------------------------
 #include <disposer/parse.hpp>
+#include <disposer/check_semantic.hpp>
 #include <disposer/mask_non_print.hpp>
 
 #include <iostream>
@@ -416,12 +417,91 @@ chain
 	,
 "Syntax error at line 7, pos 5: '\t\t\t<-', expected keyword line '\t\t\t->\n'"
 	}
+	,
+	{
+R"file(parameter_set
+	ps1
+		p = 1
+module
+	mod1 = dmod1
+chain
+	chain1
+		run_order = relaxed
+		max_in_flight = 2
+		mod1
+			->
+				out = x1)file"
+	,
+"Syntax error at line 9, pos 15: '\t\tmax_in_flight = 2\n', expected a "
+"module '\t\tmodule\n'"
+	}
+	,
+	{
+R"file(parameter_set
+	ps1
+		p = 1
+module
+	mod1 = dmod1
+chain
+	chain1
+		max_in_flight = 2
+		max_in_flight = 3
+		mod1
+			->
+				out = x1)file"
+	,
+"Syntax error at line 9, pos 15: '\t\tmax_in_flight = 3\n', expected a "
+"module '\t\tmodule\n'"
+	}
+};
+
+std::vector< std::pair< std::string, std::string > > semantic_tests{
+	{
+R"file(parameter_set
+	ps1
+		p = 1
+module
+	mod1 = dmod1
+chain
+	chain1
+		mod1
+			color = red
+			->
+				out = x1
+)file"
+	,
+"In chain 'chain1' module 'mod1': Unknown module parameter 'color'"
+	}
+	,
+	{
+R"file(parameter_set
+	ps1
+		p = 1
+module
+	mod1 = dmod1
+chain
+	chain1
+		mod1
+			stage = a
+			stage = b
+			->
+				out = x1
+)file"
+	,
+"In chain 'chain1' module 'mod1': Duplicate parameter 'stage'"
+	}
 };
 
-int parse(std::size_t i, std::string content, std::string const& message){
+int parse(
+	std::size_t i,
+	std::string content,
+	std::string const& message,
+	bool semantic
+){
 	try{
 		std::istringstream file(content);
-		disposer::parse(file);
+		auto const config = disposer::parse(file);
+		if(semantic) disposer::check_semantic(config);
 		return fail(i, "No exception");
 	}catch(std::exception const& e){
 		if(e.what() == message){
@@ -439,7 +519,10 @@ int main(){
 	std::size_t i = 0;
 	std::size_t r = 0;
 	for(auto const& v: tests){
-		r += parse(i++, v.first, v.second);
+		r += parse(i++, v.first, v.second, false);
+	}
+	for(auto const& v: semantic_tests){
+		r += parse(i++, v.first, v.second, true);
 	}
 
 	if(r == 0){
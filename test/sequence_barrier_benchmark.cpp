@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/sequence_barrier.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+
+// The old chain::process_module scheme: one mutex per module and one
+// condition variable shared by all modules of the chain
+class turnstile{
+public:
+	turnstile(std::size_t module_count):
+		ready_run_(module_count),
+		mutexes_(module_count),
+		wakeups_(0) {}
+
+	template < typename F >
+	void process(std::size_t i, std::size_t run, F const& f){
+		std::unique_lock< std::mutex > lock(mutexes_[i]);
+		bool first = true;
+		cv_.wait(lock, [this, i, run, &first]{
+			if(!first) ++wakeups_;
+			first = false;
+			return ready_run_[i] == run;
+		});
+
+		f();
+
+		ready_run_[i] = run + 1;
+		cv_.notify_all();
+	}
+
+	std::size_t wakeups()const{ return wakeups_; }
+
+private:
+	std::vector< std::size_t > ready_run_;
+	std::vector< std::mutex > mutexes_;
+	std::condition_variable cv_;
+	std::atomic< std::size_t > wakeups_;
+};
+
+// The new scheme: one sequence_barrier per module
+class barriers{
+public:
+	barriers(std::size_t module_count):
+		ready_run_(module_count) {}
+
+	template < typename F >
+	void process(std::size_t i, std::size_t run, F const& f){
+		ready_run_[i].wait(run);
+		f();
+		ready_run_[i].release(run);
+	}
+
+	std::size_t wakeups()const{
+		std::size_t result = 0;
+		for(auto& barrier: ready_run_) result += barrier.wakeups();
+		return result;
+	}
+
+private:
+	std::vector< disposer::sequence_barrier > ready_run_;
+};
+
+
+void work(){
+	auto const end = std::chrono::steady_clock::now()
+		+ std::chrono::microseconds(5);
+	while(std::chrono::steady_clock::now() < end);
+}
+
+template < typename Scheme >
+void benchmark(
+	char const* name,
+	std::size_t module_count,
+	std::size_t thread_count,
+	std::size_t run_count
+){
+	Scheme scheme(module_count);
+	std::atomic< std::size_t > next_run(0);
+
+	auto const start = std::chrono::steady_clock::now();
+
+	std::vector< std::thread > threads;
+	for(std::size_t t = 0; t < thread_count; ++t){
+		threads.emplace_back([&]{
+			for(;;){
+				std::size_t const run = next_run++;
+				if(run >= run_count) break;
+				for(std::size_t i = 0; i < module_count; ++i){
+					scheme.process(i, run, work);
+				}
+			}
+		});
+	}
+
+	for(auto& thread: threads) thread.join();
+
+	auto const time = std::chrono::duration< double, std::milli >(
+		std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::setw(10) << name
+		<< " modules " << std::setw(2) << module_count
+		<< " threads " << std::setw(2) << thread_count
+		<< " wakeups/run " << std::setw(8) << std::fixed
+		<< std::setprecision(2)
+		<< double(scheme.wakeups()) / run_count
+		<< " time " << std::setw(8) << time << " ms\n";
+}
+
+
+int main(){
+	std::size_t const run_count = 2000;
+	for(std::size_t thread_count: {1, 4, 8, 16}){
+		benchmark< turnstile >("turnstile", 12, thread_count, run_count);
+		benchmark< barriers >("barrier", 12, thread_count, run_count);
+	}
+}
@@ -0,0 +1,109 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015-2017 Benjamin Buch
+//
+// https://github.com/bebuch/disposer
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at https://www.boost.org/LICENSE_1_0.txt)
+//-----------------------------------------------------------------------------
+#include <disposer/module.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <array>
+
+
+using boost::typeindex::type_id_with_cvr;
+
+
+// Put to an output that is connected to fan_out inputs, int is passed by
+// value, std::array< double, 8 > via output_data_ptr
+template < typename T >
+void benchmark(char const* name, std::size_t fan_out, std::size_t put_count){
+	disposer::output< T > out{"out"};
+	std::vector< std::unique_ptr< disposer::input< T > > > inputs;
+
+	out.template enable< T >();
+	for(std::size_t i = 0; i < fan_out; ++i){
+		inputs.push_back(std::make_unique< disposer::input< T > >("in"));
+		auto& in = *inputs.back();
+
+		static_cast< disposer::input_base& >(in).enable_types(
+			disposer::make_creator_key(), {type_id_with_cvr< T >()});
+		out.get_signal(disposer::make_creator_key())
+			.connect({type_id_with_cvr< T >()}, {in}, i + 1 == fan_out);
+	}
+
+	disposer::exec_context context(0, 0, 1);
+	disposer::exec_context_scope scope(context);
+
+	auto const start = std::chrono::steady_clock::now();
+
+	for(std::size_t i = 0; i < put_count; ++i){
+		out.put(T{});
+
+		// drain the inputs from time to time
+		if(i % 64 == 63){
+			for(auto& in: inputs) in->get();
+		}
+	}
+
+	auto const time = std::chrono::duration< double, std::nano >(
+		std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::setw(8) << name
+		<< " fan-out " << std::setw(2) << fan_out
+		<< " time/put " << std::setw(8) << std::fixed
+		<< std::setprecision(2) << time / put_count << " ns"
+		<< " time/delivery " << std::setw(8) << std::fixed
+		<< std::setprecision(2) << time / (put_count * fan_out) << " ns\n";
+}
+
+
+// Get data for write access from inputs that share it with another input,
+// int is copied into the input, std::array< double, 8 > is shared
+template < typename T >
+void benchmark_get(char const* name, std::size_t get_count){
+	disposer::signal_data_t< T > data{};
+	if constexpr(!disposer::is_inline_data_v< T >){
+		data = std::make_shared< disposer::output_data< T > >(T{});
+	}
+
+	std::vector< disposer::input_data< T > > inputs;
+	inputs.reserve(get_count);
+	for(std::size_t i = 0; i < get_count; ++i){
+		inputs.emplace_back(data, false);
+	}
+
+	auto const start = std::chrono::steady_clock::now();
+
+	std::size_t sum = 0;
+	for(auto& in: inputs){
+		auto value = in.get();
+		sum += *reinterpret_cast< unsigned char const* >(&value->data());
+	}
+
+	auto const time = std::chrono::duration< double, std::nano >(
+		std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::setw(8) << name
+		<< " get()       time/get " << std::setw(8) << std::fixed
+		<< std::setprecision(2) << time / get_count << " ns"
+		<< (sum == 0 ? "\n" : " wrong data\n");
+}
+
+
+int main(){
+	std::size_t const put_count = 1000000;
+
+	for(std::size_t fan_out: {1, 4, 16}){
+		benchmark< int >("inline", fan_out, put_count);
+		benchmark< std::array< double, 8 > >("shared", fan_out, put_count);
+	}
+
+	benchmark_get< int >("inline", put_count);
+	benchmark_get< std::array< double, 8 > >("shared", put_count);
+}